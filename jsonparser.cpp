@@ -1,11 +1,58 @@
 #include <iostream>
 #include <variant>
 #include <vector>
+#include <array>
 #include <map>
 #include <optional>
+#include <utility>
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <memory>
+#include <charconv>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <shared_mutex>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <limits>
+#include <cmath>
+#include <stdexcept>
+#include <cerrno>
+#include <climits>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define JSON_HAS_MMAP 1
+#define JSON_HAS_POSIX 1
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define JSON_HAS_X86_SIMD 1
+#endif
+#ifndef JSON_STATS
+#define JSON_STATS 0 // 用 -DJSON_STATS=1 启用 json::stats 计数
+#endif
+#ifndef JSON_NODE_CACHE
+#define JSON_NODE_CACHE 0 // 用 -DJSON_NODE_CACHE=1 启用 generate_cached 的节点序列化缓存
+#endif
 namespace json
 {
 
@@ -30,12 +77,433 @@ namespace json
     // 定义数组类型，其中每个元素都是Node类型。
     using Array = std::vector<Node>;
 
-    // 定义对象类型，是一个键值对集合，键为字符串，值为Node类型。
-    using Object = std::map<std::string, Node>;
+    class KeyPool;
+
+    /*
+     * 结构体: InternedKey
+     * 描述: 键池中的一个条目。地址在键池的生命周期内保持不变，因此可以作为键的句柄。
+     */
+    struct InternedKey
+    {
+        std::string text;              ///< 键的文本
+        size_t hash = 0;               ///< std::hash<std::string_view> 的预计算结果
+        uint32_t id = 0;               ///< 键池内从 0 开始的编号
+        const KeyPool *pool = nullptr; ///< 所属键池
+    };
+
+    /*
+     * 类名: KeyPool
+     * 描述: 线程安全的键驻留表。同一键池中文本相同的键得到同一个 InternedKey，
+     *       可在多个 JsonParser 和线程之间共享；命中只取共享锁，未命中才取独占锁插入。
+     *       键池必须比所有引用其句柄的 Object 活得更久。
+     */
+    class KeyPool
+    {
+    public:
+        /* 命中 / 未命中统计 */
+        struct Stats
+        {
+            size_t hits = 0;   ///< 已存在的键
+            size_t misses = 0; ///< 新插入的键
+            size_t size = 0;   ///< 池中不同键的个数
+        };
+
+        KeyPool() = default;
+        KeyPool(const KeyPool &) = delete;
+        KeyPool &operator=(const KeyPool &) = delete;
+
+        /* 函数名称: intern
+         * 功能描述: 返回 text 对应的驻留句柄，不存在时插入。
+         */
+        auto intern(std::string_view text) -> const InternedKey *
+        {
+            {
+                std::shared_lock lock(mutex);
+                auto it = index.find(text);
+                if (it != index.end())
+                {
+                    hits.fetch_add(1, std::memory_order_relaxed);
+                    return it->second;
+                }
+            }
+            std::unique_lock lock(mutex);
+            auto it = index.find(text); // 可能已被其他线程插入
+            if (it != index.end())
+            {
+                hits.fetch_add(1, std::memory_order_relaxed);
+                return it->second;
+            }
+            misses.fetch_add(1, std::memory_order_relaxed);
+            auto &key = keys.emplace_back();
+            key.text = std::string(text);
+            key.hash = std::hash<std::string_view>{}(text);
+            key.id = uint32_t(keys.size() - 1);
+            key.pool = this;
+            index.emplace(key.text, &key);
+            return &key;
+        }
+
+        /* 函数名称: find
+         * 功能描述: 只查找不插入，不计入统计。
+         * 返回值: 不存在时为 nullptr
+         */
+        auto find(std::string_view text) const -> const InternedKey *
+        {
+            std::shared_lock lock(mutex);
+            auto it = index.find(text);
+            return it == index.end() ? nullptr : it->second;
+        }
+
+        auto stats() const -> Stats
+        {
+            std::shared_lock lock(mutex);
+            return Stats{hits.load(std::memory_order_relaxed), misses.load(std::memory_order_relaxed), keys.size()};
+        }
+
+        void reset_stats()
+        {
+            hits.store(0, std::memory_order_relaxed);
+            misses.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        mutable std::shared_mutex mutex;
+        std::deque<InternedKey> keys;                                        ///< deque 追加时不移动已有元素
+        std::unordered_map<std::string_view, const InternedKey *> index; ///< 视图指向 keys 中的文本
+        std::atomic<size_t> hits{0}, misses{0};
+    };
+
+    /*
+     * 类名: Key
+     * 描述: 对象的键。要么自己持有文本，要么只持有一个驻留句柄（不分配内存）。
+     *       两个键来自同一键池时只比较指针；其余情况比较文本。
+     */
+    class Key
+    {
+    public:
+        Key() = default;
+        explicit Key(std::string text) : text(std::move(text)) {}
+        explicit Key(const InternedKey *interned) : interned(interned) {}
+
+        auto view() const -> std::string_view { return interned ? std::string_view(interned->text) : std::string_view(text); }
+        operator std::string_view() const { return view(); }
+        auto str() const -> std::string { return std::string(view()); }
+        /* 取走自己持有的文本（驻留键返回空串），之后键为空；用于回收文本的容量 */
+        auto take_text() -> std::string { return std::move(text); }
+
+        /* 驻留句柄，未驻留时为 nullptr */
+        auto handle() const -> const InternedKey * { return interned; }
+        auto hash() const -> size_t { return interned ? interned->hash : std::hash<std::string_view>{}(text); }
+
+        friend auto operator==(const Key &a, const Key &b) -> bool
+        {
+            if (a.interned && b.interned && a.interned->pool == b.interned->pool)
+                return a.interned == b.interned;
+            return a.view() == b.view();
+        }
+        friend auto operator!=(const Key &a, const Key &b) -> bool { return !(a == b); }
+        friend auto operator==(const Key &a, std::string_view b) -> bool { return a.view() == b; }
+        friend auto operator!=(const Key &a, std::string_view b) -> bool { return a.view() != b; }
+        friend auto operator==(std::string_view a, const Key &b) -> bool { return a == b.view(); }
+        friend auto operator!=(std::string_view a, const Key &b) -> bool { return a != b.view(); }
+        friend auto operator<<(std::ostream &out, const Key &key) -> std::ostream & { return out << key.view(); }
+
+    private:
+        std::string text{};                   ///< 未驻留时的文本
+        const InternedKey *interned = nullptr; ///< 驻留句柄
+    };
+
+    /*
+     * 类名: FlatObject
+     * 描述: 扁平对象容器。成员按插入顺序连续存放在一个 (键, 值) 向量中，没有逐成员的树节点分配；
+     *       成员数不超过 Threshold 时线性查找，超过后额外维护一张开放寻址的哈希索引（Hash 可替换）。
+     *       键为 Key：驻留键之间的查找只比较指针，默认哈希下还会复用键池预计算的哈希值。
+     *       接口是 std::map 的常用子集（find/at/operator[]/count/erase/迭代），遍历顺序为插入顺序。
+     *       K 也可以是 std::string_view（借用模式的对象），此时只能用 K 类型的键插入。
+     */
+    template <class Mapped, class Hash = std::hash<std::string_view>, size_t Threshold = 8, class K = Key>
+    class FlatObject
+    {
+    public:
+        using key_type = K;
+        using mapped_type = Mapped;
+        using value_type = std::pair<K, Mapped>;
+        using iterator = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        FlatObject() = default;
+        FlatObject(std::initializer_list<std::pair<std::string, Mapped>> init)
+        {
+            for (const auto &kv : init)
+                insert_or_assign(kv.first, kv.second);
+        }
+
+        auto begin() -> iterator { return entries.begin(); }
+        auto end() -> iterator { return entries.end(); }
+        auto begin() const -> const_iterator { return entries.begin(); }
+        auto end() const -> const_iterator { return entries.end(); }
+        auto size() const -> size_t { return entries.size(); }
+        auto empty() const -> bool { return entries.empty(); }
+        void reserve(size_t n) { entries.reserve(n); }
+        void clear()
+        {
+            entries.clear();
+            slots.clear();
+        }
+
+        auto find(std::string_view key) -> iterator
+        {
+            size_t i = lookup(key);
+            return i == npos ? entries.end() : entries.begin() + i;
+        }
+        auto find(std::string_view key) const -> const_iterator
+        {
+            size_t i = lookup(key);
+            return i == npos ? entries.end() : entries.begin() + i;
+        }
+        auto find(const Key &key) -> iterator
+        {
+            size_t i = lookup(key);
+            return i == npos ? entries.end() : entries.begin() + i;
+        }
+        auto find(const Key &key) const -> const_iterator
+        {
+            size_t i = lookup(key);
+            return i == npos ? entries.end() : entries.begin() + i;
+        }
+        auto count(std::string_view key) const -> size_t { return lookup(key) != npos; }
+        auto count(const Key &key) const -> size_t { return lookup(key) != npos; }
+        auto contains(std::string_view key) const -> bool { return lookup(key) != npos; }
+        auto contains(const Key &key) const -> bool { return lookup(key) != npos; }
+
+        /* 函数名称: at
+         * 异常: std::out_of_range 如果键不存在（与 std::map::at 一致）。
+         */
+        auto at(std::string_view key) -> Mapped &
+        {
+            size_t i = lookup(key);
+            if (i == npos)
+                throw std::out_of_range("key not found");
+            return entries[i].second;
+        }
+        auto at(std::string_view key) const -> const Mapped &
+        {
+            size_t i = lookup(key);
+            if (i == npos)
+                throw std::out_of_range("key not found");
+            return entries[i].second;
+        }
+
+        /* 函数名称: operator[]
+         * 功能描述: 返回键对应的值，键不存在时在末尾插入一个默认值。
+         */
+        auto operator[](const std::string &key) -> Mapped &
+        {
+            size_t i = lookup(key);
+            return i != npos ? entries[i].second : append(Key{key}, Mapped{});
+        }
+        auto operator[](std::string &&key) -> Mapped &
+        {
+            size_t i = lookup(key);
+            return i != npos ? entries[i].second : append(Key{std::move(key)}, Mapped{});
+        }
+        auto operator[](const InternedKey *key) -> Mapped &
+        {
+            Key k{key};
+            size_t i = lookup(k);
+            return i != npos ? entries[i].second : append(std::move(k), Mapped{});
+        }
+
+        /* 函数名称: insert_or_assign
+         * 返回值: 指向该成员的迭代器，以及是否为新插入
+         */
+        auto insert_or_assign(std::string key, Mapped value) -> std::pair<iterator, bool>
+        {
+            return insert_or_assign(Key{std::move(key)}, std::move(value));
+        }
+        auto insert_or_assign(K key, Mapped value) -> std::pair<iterator, bool>
+        {
+            size_t i = lookup(key);
+            if (i != npos)
+            {
+                entries[i].second = std::move(value);
+                return {entries.begin() + i, false};
+            }
+            append(std::move(key), std::move(value));
+            return {entries.end() - 1, true};
+        }
+
+        /* 函数名称: emplace
+         * 功能描述: 键已存在时不覆盖（与 std::map::emplace 一致）。
+         */
+        auto emplace(std::string key, Mapped value) -> std::pair<iterator, bool>
+        {
+            return emplace(Key{std::move(key)}, std::move(value));
+        }
+        auto emplace(K key, Mapped value) -> std::pair<iterator, bool>
+        {
+            size_t i = lookup(key);
+            if (i != npos)
+                return {entries.begin() + i, false};
+            append(std::move(key), std::move(value));
+            return {entries.end() - 1, true};
+        }
+
+        /* 函数名称: try_emplace
+         * 功能描述: 键不存在时用 args 原地构造值，已存在时不构造也不覆盖（与 std::map::try_emplace 一致）。
+         */
+        template <class... Args>
+        auto try_emplace(std::string key, Args &&...args) -> std::pair<iterator, bool>
+        {
+            size_t i = lookup(key);
+            if (i != npos)
+                return {entries.begin() + i, false};
+            append(Key{std::move(key)}, std::forward<Args>(args)...);
+            return {entries.end() - 1, true};
+        }
+
+        /* 函数名称: erase
+         * 功能描述: 删除成员并保持其余成员的顺序；有哈希索引时需要重建索引，复杂度 O(n)。
+         */
+        auto erase(const_iterator it) -> iterator
+        {
+            auto next = entries.erase(it);
+            if (!slots.empty())
+                rehash();
+            return next;
+        }
+        auto erase(std::string_view key) -> size_t
+        {
+            size_t i = lookup(key);
+            if (i == npos)
+                return 0;
+            erase(entries.begin() + i);
+            return 1;
+        }
+
+    private:
+        static constexpr size_t npos = SIZE_MAX;
+
+        std::vector<value_type> entries; ///< 按插入顺序存放的成员
+        std::vector<uint32_t> slots;     ///< 哈希索引，0 为空槽，否则为成员下标 + 1；成员数不超过 Threshold 时为空
+
+        auto lookup(std::string_view key) const -> size_t
+        {
+            if (slots.empty())
+            {
+                for (size_t i = 0; i < entries.size(); i++)
+                    if (entries[i].first == key)
+                        return i;
+                return npos;
+            }
+            size_t mask = slots.size() - 1;
+            for (size_t h = Hash{}(key) & mask; slots[h]; h = (h + 1) & mask)
+                if (entries[slots[h] - 1].first == key)
+                    return slots[h] - 1;
+            return npos;
+        }
+
+        /* 驻留键的查找：同一键池的键之间只比较指针 */
+        auto lookup(const Key &key) const -> size_t
+        {
+            if (!key.handle())
+                return lookup(key.view());
+            if (slots.empty())
+            {
+                for (size_t i = 0; i < entries.size(); i++)
+                    if (entries[i].first == key)
+                        return i;
+                return npos;
+            }
+            size_t mask = slots.size() - 1;
+            for (size_t h = hash_of(key) & mask; slots[h]; h = (h + 1) & mask)
+                if (entries[slots[h] - 1].first == key)
+                    return slots[h] - 1;
+            return npos;
+        }
+
+        static auto hash_of(const Key &key) -> size_t
+        {
+            if constexpr (std::is_same_v<Hash, std::hash<std::string_view>>)
+                return key.hash();
+            else
+                return Hash{}(key.view());
+        }
+        static auto hash_of(std::string_view key) -> size_t { return Hash{}(key); }
+
+        template <class... Args>
+        auto append(K &&key, Args &&...args) -> Mapped &
+        {
+            entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                 std::forward_as_tuple(std::forward<Args>(args)...));
+            if (slots.empty() ? entries.size() > Threshold : entries.size() * 2 > slots.size())
+                rehash();
+            else if (!slots.empty())
+                place(entries.size() - 1);
+            return entries.back().second;
+        }
+
+        /* 重建哈希索引，保持装载因子不超过 1/2 */
+        void rehash()
+        {
+            if (entries.size() <= Threshold)
+            {
+                slots.clear();
+                return;
+            }
+            size_t capacity = 16;
+            while (capacity < entries.size() * 2)
+                capacity *= 2;
+            slots.assign(capacity, 0);
+            for (size_t i = 0; i < entries.size(); i++)
+                place(i);
+        }
+
+        void place(size_t i)
+        {
+            size_t mask = slots.size() - 1;
+            size_t h = hash_of(entries[i].first) & mask;
+            while (slots[h])
+                h = (h + 1) & mask;
+            slots[h] = uint32_t(i + 1);
+        }
+    };
+
+    // 定义对象类型，是一个按插入顺序存放的键值对集合，键为字符串，值为Node类型。
+    using Object = FlatObject<Node>;
 
     // 定义Value为以上类型的变体，能够存储任何一种类型的值。
     using Value = std::variant<Null, Bool, Int, Float, String, Array, Object>;
 
+#if JSON_NODE_CACHE
+    /*
+     * 类名: TextCache
+     * 描述: 容器节点序列化文本的缓存（由 JsonGenerator::generate_cached 填充），空时只占一个指针。
+     *       复制节点时不复制缓存，移动时随值一起移动。只在 JSON_NODE_CACHE=1 时编译，默认的 Node 不带缓存。
+     */
+    class TextCache
+    {
+    public:
+        TextCache() = default;
+        TextCache(const TextCache &) noexcept {}
+        TextCache(TextCache &&) noexcept = default;
+        TextCache &operator=(const TextCache &) noexcept
+        {
+            text.reset();
+            return *this;
+        }
+        TextCache &operator=(TextCache &&) noexcept = default;
+
+        /* 缓存的文本，没有缓存时为 nullptr */
+        auto get() const -> const std::string * { return text.get(); }
+        void store(std::string s) { text = std::make_unique<std::string>(std::move(s)); }
+        void reset() noexcept { text.reset(); }
+
+    private:
+        std::unique_ptr<std::string> text;
+    };
+#endif
+
     /**
      * @brief Node结构用于存储不同类型的数据，支持空类型、布尔、整数、浮点数、字符串、数组和对象。
      */
@@ -43,18 +511,53 @@ namespace json
     {
         Value value; ///< 存储节点值的变体。
 
+#if JSON_NODE_CACHE
+        /**
+         * 序列化缓存（仅 JSON_NODE_CACHE=1）。每个非 const 的访问和修改函数都会先清除当前节点的缓存，因此从根出发经
+         * operator[] 修改后代时，路径上所有祖先的缓存都会失效，而兄弟子树的缓存保持不变；只读访问请用 const 引用，
+         * 否则同样会清除缓存。直接修改 value，或者在两次生成之间保留并通过旧引用修改后代时，
+         * 需要对路径上的节点调用 invalidate()。const 的生成也会写入缓存，同一棵树不能被多个线程同时 generate_cached。
+         */
+        mutable TextCache cache;
+#endif
+
         /**
          * @brief 构造函数，初始化Node为特定值。
          *
-         * @param _value 要存储在节点中的值。
+         * @param _value 要存储在节点中的值（按值传入后移动进成员，传右值时不会复制子树）。
          */
-        Node(Value _value) : value(_value) {}
+        Node(Value _value) : value(std::move(_value)) {}
 
         /**
          * @brief 默认构造函数，初始化Node为Null。
          */
         Node() : value(Null{}) {}
 
+        Node(const Node &) = default;
+        Node(Node &&) = default;
+        Node &operator=(const Node &) = default;
+        Node &operator=(Node &&) = default;
+
+        /**
+         * @brief 析构函数。子容器先被移进一个显式的待释放列表再逐个销毁，
+         *        因此销毁任意深的树时调用栈不随深度增长。
+         */
+        ~Node()
+        {
+            if (!std::holds_alternative<Array>(value) && !std::holds_alternative<Object>(value))
+            {
+                return; // 标量与字符串没有子节点
+            }
+            std::vector<Node> pending;
+            detach_children(pending);
+            while (!pending.empty())
+            {
+                Node last = std::move(pending.back());
+                pending.pop_back();
+                last.detach_children(pending); // last 析构时只剩不含子容器的元素
+            }
+        }
+
         /**
          * @brief 通过键访问对象类型的值。
          *
@@ -66,489 +569,9222 @@ namespace json
         {
             if (auto object = std::get_if<Object>(&value))
             {
+                invalidate();
                 return (*object)[key];
             }
             throw std::runtime_error("not an object");
         }
 
         /**
-         * @brief 通过索引访问数组类型的值。
+         * @brief 只读访问对象成员，键不存在时不会插入。
          *
-         * @param index 数组中的索引。
-         * @return 数组中索引对应的值的副本。
-         * @throws std::runtime_error 如果当前Node不是数组类型。
+         * @throws std::runtime_error 如果当前Node不是对象类型或键不存在。
          */
-        auto operator[](size_t index)
+        auto operator[](const std::string &key) const -> const Node &
         {
-            if (auto array = std::get_if<Array>(&value))
+            if (auto object = std::get_if<Object>(&value))
             {
-                return array->at(index);
+                auto it = object->find(key);
+                if (it == object->end())
+                    throw std::runtime_error("key not found");
+                return it->second;
             }
-            throw std::runtime_error("not an array");
+            throw std::runtime_error("not an object");
         }
 
         /**
-         * @brief 向数组类型的Node添加一个新的Node元素。
+         * @brief 通过索引访问数组类型的值。
          *
-         * @param rhs 要添加到数组中的Node。
-         * @throws std::runtime_error 如果当前Node不是数组类型。
+         * @param index 数组中的索引。
+         * @return 数组中索引对应的值的引用。
+         * @throws std::runtime_error 如果当前Node不是数组类型；std::out_of_range 如果越界。
          */
-        void push(const Node &rhs)
+        auto operator[](size_t index) -> Node &
         {
             if (auto array = std::get_if<Array>(&value))
             {
-                array->push_back(rhs);
+                invalidate();
+                return array->at(index);
             }
+            throw std::runtime_error("not an array");
         }
-    };
-
-    struct JsonParser
-    {
-        /* 解析 JSON 字符串的视图 */
-        std::string_view json_str;
-        /* 当前解析位置 */
-        size_t pos = 0;
 
-        /* 函数名称: parse_whitespace
-         * 功能描述: 跳过 JSON 字符串中的空白字符，包括空格、制表符等。
-         * 参数:
-         *     - 无（使用成员变量 json_str 和 pos）
-         * 返回值:
-         *     - void（不返回任何值，直接修改 pos 的值）
-         */
-        void parse_whitespace()
+        auto operator[](size_t index) const -> const Node &
         {
-            // 循环条件：当前位置小于 JSON 字符串的长度，并且当前字符是空白字符
-            while (pos < json_str.size() && std::isspace(json_str[pos]))
+            if (auto array = std::get_if<Array>(&value))
             {
-                ++pos; // 如果是空白字符，则 pos 自增，跳过该字符
+                return array->at(index);
             }
+            throw std::runtime_error("not an array");
         }
 
-        /* 函数名称: parse_null
-         * 功能描述: 从当前位置开始解析 JSON 字符串中的 null 值。
-         * 参数:
-         *     - 无（使用成员变量 json_str 和 pos）
-         * 返回值:
-         *     - std::optional<Value>（解析成功时返回 Null 类型的值，失败时返回空 optional）
+        /**
+         * @brief 向数组类型的Node添加一个新的Node元素，不是数组时忽略。
+         *
+         * @param rhs 要添加到数组中的Node；传右值时直接移动。
          */
-        auto parse_null() -> std::optional<Value>
+        void push(const Node &rhs)
         {
-            // 判断从当前位置开始的 4 个字符是否为 "null"
-            if (json_str.substr(pos, 4) == "null")
+            if (auto array = std::get_if<Array>(&value))
             {
-                pos += 4;      // 如果是，则 pos 增加 4，跳过 "null"
-                return Null{}; // 并返回 Null 类型的值
+                invalidate();
+                array->push_back(rhs);
             }
-            return {}; // 如果不是 "null"，返回空 optional
         }
 
-        /* 函数名称: parse_true
-         * 功能描述: 从当前位置开始解析 JSON 字符串中的 true 值。
-         * 参数:
-         *     - 无（使用成员变量 json_str 和 pos）
-         * 返回值:
-         *     - std::optional<Value>（解析成功时返回 true，失败时返回空 optional）
-         */
-        auto parse_true() -> std::optional<Value>
+        void push(Node &&rhs)
         {
-            // 判断从当前位置开始的 4 个字符是否为 "true"
-            if (json_str.substr(pos, 4) == "true")
+            if (auto array = std::get_if<Array>(&value))
             {
-                pos += 4;    // 如果是，则 pos 增加 4，跳过 "true"
-                return true; // 并返回 true
+                invalidate();
+                array->push_back(std::move(rhs));
             }
-            return {}; // 如果不是 "true"，返回空 optional
         }
 
-        /* 函数名称: parse_false
-         * 功能描述: 从当前位置开始解析 JSON 字符串中的 false 值。
-         * 参数:
-         *     - 无（使用成员变量 json_str 和 pos）
-         * 返回值:
-         *     - std::optional<Value>（解析成功时返回 false，失败时返回空 optional）
+        /**
+         * @brief 在数组末尾原地构造一个元素。
+         *
+         * @return 新元素的引用。
+         * @throws std::runtime_error 如果当前Node不是数组类型。
          */
-        auto parse_false() -> std::optional<Value>
+        template <class... Args>
+        auto emplace_back(Args &&...args) -> Node &
         {
-            // 判断从当前位置开始的 5 个字符是否为 "false"
-            if (json_str.substr(pos, 5) == "false")
+            if (auto array = std::get_if<Array>(&value))
             {
-                pos += 5;     // 如果是，则 pos 增加 5，跳过 "false"
-                return false; // 并返回 false
+                invalidate();
+                return array->emplace_back(std::forward<Args>(args)...);
             }
-            return {}; // 如果不是 "false"，返回空 optional
+            throw std::runtime_error("not an array");
         }
 
         /**
-         * 函数名称: parse_number
-         * 功能描述:
-         *     解析 JSON 字符串中的数字。这个函数尝试从当前位置（pos）开始解析一个数字，
-         *     并根据数字的格式（整数或浮点数）来返回相应的值。如果遇到非数字字符，则停止解析。
-         *     函数支持识别标准的 JSON 数字格式，包括指数表示法。
-         * 参数: 无
-         * 返回值:
-         *     std::optional<Value> - 如果解析成功，返回一个包含数字（整数或浮点数）的 Value 对象；
-         *                            如果解析失败或遇到异常，则返回一个空的 optional 对象。
+         * @brief 键不存在时原地构造成员，已存在时什么也不做（与 std::map::try_emplace 一致）。
+         *
+         * @return 成员的引用，以及是否为新插入。
+         * @throws std::runtime_error 如果当前Node不是对象类型。
          */
-        auto parse_number() -> std::optional<Value>
+        template <class... Args>
+        auto try_emplace(std::string key, Args &&...args) -> std::pair<Node &, bool>;
+
+        /**
+         * @brief 清除当前节点的序列化缓存（直接修改 value 之后调用）；未启用 JSON_NODE_CACHE 时什么也不做。
+         */
+        void invalidate() noexcept
         {
-            size_t endpos = pos; // 初始化结束位置为当前解析的起始位置
-            // 循环查找数字的结束位置，包括数字、指数表示符'e'和小数点
-            while (endpos < json_str.size() && (std::isdigit(json_str[endpos]) ||
-                                                json_str[endpos] == 'e' ||
-                                                json_str[endpos] == '.'))
-            {
-                endpos++; // 移动结束位置指针
-            }
-            // 根据起始位置和结束位置截取数字字符串
-            std::string number = std::string{json_str.substr(pos, endpos - pos)};
-            pos = endpos; // 更新解析器的当前位置为数字的结束位置
+#if JSON_NODE_CACHE
+            cache.reset();
+#endif
+        }
 
-            // 定义一个 lambda 函数，用于判断字符串是否表示浮点数（包含'.'或'e'）
-            static auto is_Float = [](std::string &number)
+    private:
+        /* 把直接子节点中的数组和对象移进 pending，原位置只留下移动后的空容器 */
+        void detach_children(std::vector<Node> &pending)
+        {
+            auto detach = [&](Node &child)
             {
-                return number.find('.') != number.npos || number.find('e') != number.npos;
+                auto array = std::get_if<Array>(&child.value);
+                auto object = std::get_if<Object>(&child.value);
+                if ((array && !array->empty()) || (object && !object->empty()))
+                    pending.push_back(std::move(child)); // 空容器没有子节点，留在原处直接销毁
             };
-
-            if (is_Float(number)) // 如果是浮点数
+            if (auto array = std::get_if<Array>(&value))
             {
-                try
-                {
-                    Float ret = std::stod(number); // 尝试将字符串转换为浮点数
-                    return ret;                    // 返回转换后的浮点数
-                }
-                catch (...) // 捕获所有类型的异常
-                {
-                    return {}; // 发生异常，返回空的 optional 对象
-                }
+                for (auto &child : *array)
+                    detach(child);
             }
-            else // 如果是整数
+            else if (auto object = std::get_if<Object>(&value))
             {
-                try
-                {
-                    Int ret = std::stoi(number); // 尝试将字符串转换为整数
-                    return ret;                  // 返回转换后的整数
-                }
-                catch (...) // 捕获所有类型的异常
-                {
-                    return {}; // 发生异常，返回空的 optional 对象
-                }
+                for (auto &member : *object)
+                    detach(member.second);
             }
         }
+    };
 
-        /**
-         * 函数名称: parse_string
-         * 功能描述:
-         *     从当前位置开始解析 JSON 字符串中的字符串值。这个函数寻找以双引号(")开始和结束的文本，
-         *     并将其内容作为字符串值返回。
-         * 参数: 无
-         * 返回值:
-         *     std::optional<Value> - 如果成功解析字符串，返回包含该字符串的 Value 对象；
-         *                            如果失败，则返回空的 optional 对象。
-         */
-        auto parse_string() -> std::optional<Value>
+    static_assert(std::is_nothrow_move_constructible_v<Node>, "vector<Node> 扩容时必须移动而不是复制");
+    static_assert(JSON_NODE_CACHE || sizeof(Node) == sizeof(Value), "默认的 Node 不能比 Value 多占内存");
+
+    template <class... Args>
+    auto Node::try_emplace(std::string key, Args &&...args) -> std::pair<Node &, bool>
+    {
+        if (auto object = std::get_if<Object>(&value))
+        {
+            invalidate();
+            auto [it, inserted] = object->try_emplace(std::move(key), std::forward<Args>(args)...);
+            return {it->second, inserted};
+        }
+        throw std::runtime_error("not an object");
+    }
+
+    /*
+     * 命名空间: stats
+     * 描述: 可选的解析 / 生成统计，默认编译掉：用 -DJSON_STATS=1 编译时才会计数，否则所有统计代码都在
+     *       if constexpr 中被丢弃，不产生任何指令。计数器按线程保存（thread_local），由 stats::counters()
+     *       读取；多个线程的结果可以用 += 合并。只统计 json::parser（以及基于它的 parse_file、ndjson）
+     *       和 JsonGenerator 的生成函数。
+     *
+     *       堆分配通过本文件替换的全局 operator new 记录，只计入当前线程正在解析或生成期间的分配，
+     *       也就是 String、Array、Object 和解析器自身的缓冲区。空白、字符串和数字的耗时每 sample_every
+     *       次调用计时一次再按比例放大，计时本身的开销因此很小；容器处理的耗时为总耗时减去其余各项。
+     */
+    namespace stats
+    {
+        inline constexpr bool enabled = JSON_STATS != 0;
+
+        /* 每隔多少次调用对空白、字符串、数字处理计时一次 */
+        inline constexpr uint32_t sample_every = 16;
+
+        /* 解析计数 */
+        struct ParseCounters
         {
-            pos++; // 跳过开始的双引号(")
-            size_t endpos = pos;
-            // 查找字符串的结束双引号(")，标记字符串结束位置
-            while (pos < json_str.size() && json_str[endpos] != '"')
+            size_t documents = 0;       ///< 解析的文档数
+            size_t bytes = 0;           ///< 输入字节数
+            size_t nulls = 0;           ///< 各类记号的个数
+            size_t bools = 0;
+            size_t ints = 0;
+            size_t floats = 0;
+            size_t strings = 0;
+            size_t keys = 0;
+            size_t arrays = 0;
+            size_t objects = 0;
+            size_t max_depth = 0;       ///< 出现过的最大嵌套层数
+            size_t allocations = 0;     ///< 堆分配次数
+            size_t allocated_bytes = 0; ///< 堆分配的字节数
+            uint64_t total_ns = 0;      ///< 总耗时
+            uint64_t stage1_ns = 0;     ///< 结构索引和 UTF-8 校验（整块扫描）
+            uint64_t whitespace_ns = 0; ///< 跳过空白（抽样估计）
+            uint64_t string_ns = 0;     ///< 字符串和键的定位与解码（抽样估计）
+            uint64_t number_ns = 0;     ///< 数字解析（抽样估计）
+
+            auto tokens() const -> size_t { return nulls + bools + ints + floats + strings + keys + arrays + objects; }
+
+            /* 容器处理（括号、逗号、插入成员等）的耗时：总耗时中不属于其他各项的部分 */
+            auto container_ns() const -> uint64_t
             {
-                endpos++; // 移动结束位置指针
+                uint64_t rest = stage1_ns + whitespace_ns + string_ns + number_ns;
+                return total_ns > rest ? total_ns - rest : 0;
+            }
+        };
+
+        /* 生成计数 */
+        struct GenerateCounters
+        {
+            size_t documents = 0;       ///< 生成的文档数
+            size_t bytes = 0;           ///< 输出字节数
+            size_t allocations = 0;     ///< 堆分配次数
+            size_t allocated_bytes = 0; ///< 堆分配的字节数
+            uint64_t total_ns = 0;      ///< 总耗时
+        };
+
+        /* 一个线程的全部计数 */
+        struct Counters
+        {
+            ParseCounters parse;
+            GenerateCounters generate;
+
+            auto operator+=(const Counters &rhs) -> Counters &
+            {
+                auto &p = parse;
+                const auto &q = rhs.parse;
+                p.documents += q.documents;
+                p.bytes += q.bytes;
+                p.nulls += q.nulls;
+                p.bools += q.bools;
+                p.ints += q.ints;
+                p.floats += q.floats;
+                p.strings += q.strings;
+                p.keys += q.keys;
+                p.arrays += q.arrays;
+                p.objects += q.objects;
+                p.max_depth = std::max(p.max_depth, q.max_depth);
+                p.allocations += q.allocations;
+                p.allocated_bytes += q.allocated_bytes;
+                p.total_ns += q.total_ns;
+                p.stage1_ns += q.stage1_ns;
+                p.whitespace_ns += q.whitespace_ns;
+                p.string_ns += q.string_ns;
+                p.number_ns += q.number_ns;
+                generate.documents += rhs.generate.documents;
+                generate.bytes += rhs.generate.bytes;
+                generate.allocations += rhs.generate.allocations;
+                generate.allocated_bytes += rhs.generate.allocated_bytes;
+                generate.total_ns += rhs.generate.total_ns;
+                return *this;
+            }
+        };
+
+        /* 当前线程正在统计的操作 */
+        enum class Scope : uint8_t
+        {
+            None,
+            Parse,
+            Generate,
+        };
+
+        namespace detail
+        {
+            struct ThreadState
+            {
+                Counters counters;
+                Scope active = Scope::None;
+                uint32_t tick = 0; ///< 抽样计时的调用计数
+            };
+
+            /* 常量初始化，没有析构函数，在 operator new 中访问也是安全的 */
+            inline auto state() -> ThreadState &
+            {
+                thread_local ThreadState s;
+                return s;
+            }
+
+            inline auto now_ns() -> uint64_t
+            {
+                return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch())
+                                    .count());
+            }
+
+            /* 连续两次读时钟的最小间隔，从每个抽样中扣除，否则计时本身的开销会被放大 sample_every 倍 */
+            inline auto clock_overhead() -> uint64_t
+            {
+                static const uint64_t overhead = []
+                {
+                    uint64_t best = UINT64_MAX;
+                    for (int i = 0; i < 64; i++)
+                    {
+                        uint64_t t0 = now_ns();
+                        best = std::min(best, now_ns() - t0);
+                    }
+                    return best;
+                }();
+                return overhead;
             }
-            // 根据起始位置和结束位置截取字符串
-            std::string str = std::string{json_str.substr(pos, endpos - pos)};
-            pos = endpos + 1; // 更新解析器位置到结束双引号之后
-            return str;       // 返回解析得到的字符串
         }
 
-        /**
-         * 函数名称: parse_array
-         * 功能描述:
-         *     从当前位置开始解析 JSON 字符串中的数组。这个函数处理以方括号([)开始和结束的数组，
-         *     解析数组中的每个元素，并将它们作为一个 Array 返回。
-         * 参数: 无
-         * 返回值:
-         *     std::optional<Value> - 如果成功解析数组，返回包含数组元素的 Value 对象（一个 Array 类型）；
-         *                            如果解析过程中遇到任何错误，则返回空的 optional 对象。
+        /* 函数名称: counters
+         * 功能描述: 当前线程的计数器（未启用时始终为零）。
          */
-        auto parse_array() -> std::optional<Value>
+        inline auto counters() -> Counters & { return detail::state().counters; }
+
+        inline void reset() { detail::state().counters = Counters{}; }
+
+        /* 函数名称: record_allocation
+         * 功能描述: 由全局 operator new 调用，把分配计入当前线程正在进行的解析或生成。
+         */
+        inline void record_allocation(size_t bytes) noexcept
         {
-            pos++;     // 跳过开始的方括号([)
-            Array arr; // 初始化空数组
-            // 循环解析数组元素，直到遇到结束的方括号(])
-            while (pos < json_str.size() && json_str[pos] != ']')
+            if constexpr (enabled)
             {
-                auto value = parse_value();   // 解析当前元素
-                arr.push_back(value.value()); // 将解析得到的元素加入数组中
-                parse_whitespace();           // 解析并跳过任何空白字符
-                if (pos < json_str.size() && json_str[pos] == ',')
+                auto &s = detail::state();
+                if (s.active == Scope::Parse)
+                {
+                    s.counters.parse.allocations++;
+                    s.counters.parse.allocated_bytes += bytes;
+                }
+                else if (s.active == Scope::Generate)
                 {
-                    pos++; // 跳过元素间的逗号(,)
+                    s.counters.generate.allocations++;
+                    s.counters.generate.allocated_bytes += bytes;
                 }
-                parse_whitespace(); // 再次解析并跳过任何空白字符
             }
-            pos++;      // 跳过结束的方括号(])
-            return arr; // 返回解析得到的数组
         }
 
-        /**
-         * 函数名称: parse_object
-         * 功能描述:
-         *     从当前位置开始解析 JSON 字符串中的对象。这个函数处理以大括号({)开始和结束的对象，
-         *     解析对象中的每个键值对，并将它们作为一个 Object 返回。
-         * 参数: 无
-         * 返回值:
-         *     std::optional<Value> - 如果成功解析对象，返回包含对象键值对的 Value 对象（一个 Object 类型）；
-         *                            如果解析过程中遇到任何错误，例如键不是字符串类型或格式不正确，则返回空的 optional 对象。
+        /*
+         * 类名: Section
+         * 描述: 标记一次解析或生成：统计文档数和总耗时，并让期间的分配和计时计入对应的计数器。
+         *       嵌套时只有最外层生效。
          */
-        auto parse_object() -> std::optional<Value>
+        class Section
         {
-            pos++;      // 跳过开始的大括号({
-            Object obj; // 初始化空对象
-            // 循环解析键值对，直到遇到结束的大括号(})
-            while (pos < json_str.size() && json_str[pos] != '}')
+        public:
+            explicit Section(Scope scope)
+            {
+                if constexpr (enabled)
+                {
+                    auto &s = detail::state();
+                    if (s.active == Scope::None)
+                    {
+                        s.active = scope;
+                        this->scope = scope;
+                        start = detail::now_ns();
+                    }
+                }
+            }
+            ~Section()
             {
-                auto key = parse_value(); // 解析键
-                parse_whitespace();       // 解析并跳过任何空白字符
-                // 检查解析得到的键是否为字符串类型
-                if (!std::holds_alternative<String>(key.value()))
+                if constexpr (enabled)
                 {
-                    return {}; // 如果键不是字符串，返回空的 optional 对象
+                    if (scope == Scope::None)
+                        return;
+                    auto &s = detail::state();
+                    uint64_t elapsed = detail::now_ns() - start;
+                    if (scope == Scope::Parse)
+                    {
+                        s.counters.parse.documents++;
+                        s.counters.parse.total_ns += elapsed;
+                    }
+                    else
+                    {
+                        s.counters.generate.documents++;
+                        s.counters.generate.total_ns += elapsed;
+                    }
+                    s.active = Scope::None;
                 }
-                // 确认键值对中的分隔符为冒号(:)
-                if (pos < json_str.size() && json_str[pos] == ':')
+            }
+            Section(const Section &) = delete;
+            Section &operator=(const Section &) = delete;
+
+        private:
+            Scope scope = Scope::None;
+            uint64_t start = 0;
+        };
+
+        /*
+         * 类名: Timer
+         * 描述: 把一段解析工作的耗时计入 ParseCounters 的某个字段。只在解析期间计时；
+         *       sampled 为 true 时每 sample_every 次计时一次并按比例放大。
+         */
+        class Timer
+        {
+        public:
+            explicit Timer(uint64_t ParseCounters::*field, bool sampled = true)
+            {
+                if constexpr (enabled)
                 {
-                    pos++; // 跳过冒号(:)
+                    auto &s = detail::state();
+                    if (s.active == Scope::Parse && (!sampled || ++s.tick % sample_every == 0))
+                    {
+                        this->field = field;
+                        scale = sampled ? sample_every : 1;
+                        start = detail::now_ns();
+                    }
                 }
-                parse_whitespace();       // 解析并跳过任何空白字符
-                auto val = parse_value(); // 解析值
-                // 将键和值添加到对象中
-                obj[std::get<String>(key.value())] = val.value();
-                parse_whitespace(); // 解析并跳过任何空白字符
-                // 如果遇到逗号(,)，表示后面还有键值对
-                if (pos < json_str.size() && json_str[pos] == ',')
+            }
+            ~Timer()
+            {
+                if constexpr (enabled)
                 {
-                    pos++; // 跳过逗号(,)
+                    if (field)
+                    {
+                        uint64_t elapsed = detail::now_ns() - start;
+                        uint64_t overhead = detail::clock_overhead();
+                        counters().parse.*field += (elapsed > overhead ? elapsed - overhead : 0) * scale;
+                    }
                 }
-                parse_whitespace(); // 再次解析并跳过任何空白字符
             }
-            pos++;      // 跳过结束的大括号(})
-            return obj; // 返回解析得到的对象
-        }
+            Timer(const Timer &) = delete;
+            Timer &operator=(const Timer &) = delete;
 
-        /**
-         * 函数名称: parse_value
-         * 功能描述:
-         *     根据当前解析位置的字符决定并调用相应的解析函数。该函数是一个分发中心，
-         *     根据当前字符来解析 JSON 支持的不同类型的值：null, true, false, 数字, 字符串, 数组, 和对象。
-         * 参数: 无
-         * 返回值:
-         *     std::optional<Value> - 根据解析到的值的类型返回一个相应的 Value 对象；
-         *                            如果没有匹配的类型或解析过程中发生错误，则返回空的 optional 对象。
+        private:
+            uint64_t ParseCounters::*field = nullptr;
+            uint64_t scale = 1;
+            uint64_t start = 0;
+        };
+
+        /* 函数名称: count_scalar
+         * 功能描述: 按类型记录一个解析到的标量。
          */
-        auto parse_value() -> std::optional<Value>
+        inline void count_scalar(const Value &value)
         {
-            parse_whitespace(); // 首先解析并跳过任何空白字符
-            // 根据当前字符决定下一步解析哪种类型的值
-            switch (json_str[pos])
+            if constexpr (enabled)
             {
-            case 'n': // 如果是 'n'，尝试解析 null
-                return parse_null();
-            case 't': // 如果是 't'，尝试解析 true
-                return parse_true();
-            case 'f': // 如果是 'f'，尝试解析 false
-                return parse_false();
-            case '"': // 如果是 '"'，解析字符串
-                return parse_string();
-            case '[': // 如果是 '['，解析数组
-                return parse_array();
-            case '{': // 如果是 '{'，解析对象
-                return parse_object();
-            default: // 默认情况下，尝试解析数字
-                return parse_number();
+                auto &p = counters().parse;
+                switch (value.index())
+                {
+                case 0:
+                    p.nulls++;
+                    break;
+                case 1:
+                    p.bools++;
+                    break;
+                case 2:
+                    p.ints++;
+                    break;
+                case 3:
+                    p.floats++;
+                    break;
+                default:
+                    p.strings++;
+                    break;
+                }
             }
         }
 
-        /**
-         * 函数名称: parse
-         * 功能描述:
-         *     这是解析 JSON 文本的高层次入口点函数。它首先跳过任何前导的空白字符，
-         *     然后调用 parse_value 来解析 JSON 文本中的第一个值。解析成功后，这个值被用来构造一个 Node 对象。
-         * 参数: 无
-         * 返回值:
-         *     std::optional<Node> - 如果解析成功，返回一个包含解析到的值的 Node 对象；
-         *                            如果解析过程中遇到错误，则返回空的 optional 对象。
+        /* 函数名称: count_container
+         * 功能描述: 记录一个开始的数组或对象及其所在的嵌套层数（从 1 开始）。
          */
-        auto parse() -> std::optional<Node>
+        inline void count_container(bool array, size_t depth)
         {
-            parse_whitespace();         // 解析并跳过 JSON 文本前的任何空白字符
-            auto value = parse_value(); // 尝试解析 JSON 文本中的值
-            if (!value)                 // 如果解析值失败
+            if constexpr (enabled)
             {
-                return {}; // 返回空的 optional 对象，表示解析失败
+                auto &p = counters().parse;
+                (array ? p.arrays : p.objects)++;
+                p.max_depth = std::max(p.max_depth, depth);
             }
-            return Node{*value}; // 使用解析到的值构造一个 Node 对象并返回
         }
-    };
+    }
 
     /*
-     * 函数名: parser
-     * 参数: json_str - 包含 JSON 数据的 std::string_view
-     * 返回值: std::optional<Node>，一个可能包含解析后 JSON 数据的节点的可选对象
-     * 描述: 此函数接受一个 JSON 字符串，并尝试解析它。如果解析成功，则返回一个包含解析结果的节点；如果解析失败，则返回空的 std::optional。
+     * 命名空间: simd
+     * 描述: 结构索引（stage 1）。以 64 字节为一块，用 SSE2/AVX2（或标量回退）一次性找出
+     *       所有结构字符 {}[]:,、字符串引号以及标量（数字、true/false/null）的起始位置，
+     *       之后的解析只需在这些位置之间跳转，而不必逐字节重新扫描。
      */
-    auto parser(std::string_view json_str) -> std::optional<Node>
+    namespace simd
     {
-        // 创建 JsonParser 对象，并传入要解析的 JSON 字符串
-        JsonParser p{json_str};
+        /* 一个 64 字节块中各类字符的位图，第 i 位对应块内第 i 个字节 */
+        struct BlockMasks
+        {
+            uint64_t quote;      ///< '"' 的位置
+            uint64_t backslash;  ///< '\\' 的位置
+            uint64_t structural; ///< {}[]:, 的位置
+            uint64_t whitespace; ///< JSON 空白字符（空格、\t、\n、\r）的位置
+        };
 
-        // 调用 JsonParser 的 parse() 方法进行解析，并返回解析结果
-        return p.parse();
-    }
+        /* 可用的分类内核 */
+        enum class Kernel
+        {
+            Scalar,
+            SSE2,
+            AVX2
+        };
+
+        /* 函数名称: kernel_name
+         * 功能描述: 返回内核的可读名称，用于基准测试输出。
+         */
+        inline auto kernel_name(Kernel k) -> const char *
+        {
+            switch (k)
+            {
+            case Kernel::SSE2:
+                return "sse2";
+            case Kernel::AVX2:
+                return "avx2";
+            default:
+                return "scalar";
+            }
+        }
+
+        /* 函数名称: classify_scalar
+         * 功能描述: 标量回退版本，逐字节生成一个块的字符位图。
+         * 参数:
+         *     - p: 指向 64 个可读字节的指针
+         * 返回值:
+         *     - BlockMasks（该块的各类字符位图）
+         */
+        inline auto classify_scalar(const char *p) -> BlockMasks
+        {
+            BlockMasks m{0, 0, 0, 0};
+            for (int i = 0; i < 64; i++)
+            {
+                uint64_t bit = uint64_t{1} << i;
+                switch (p[i])
+                {
+                case '"':
+                    m.quote |= bit;
+                    break;
+                case '\\':
+                    m.backslash |= bit;
+                    break;
+                case '{':
+                case '}':
+                case '[':
+                case ']':
+                case ':':
+                case ',':
+                    m.structural |= bit;
+                    break;
+                case ' ':
+                case '\t':
+                case '\n':
+                case '\r':
+                    m.whitespace |= bit;
+                    break;
+                default:
+                    break;
+                }
+            }
+            return m;
+        }
+
+#ifdef JSON_HAS_X86_SIMD
+        /* 函数名称: classify_sse2
+         * 功能描述: 每次比较 16 个字节，4 次得到一个 64 字节块的位图。
+         */
+        __attribute__((target("sse2"))) inline auto classify_sse2(const char *p) -> BlockMasks
+        {
+            BlockMasks m{0, 0, 0, 0};
+            for (int i = 0; i < 4; i++)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * i));
+#define JSON_EQ16(c) _mm_cmpeq_epi8(v, _mm_set1_epi8(c))
+                __m128i structural = _mm_or_si128(_mm_or_si128(_mm_or_si128(JSON_EQ16('{'), JSON_EQ16('}')),
+                                                               _mm_or_si128(JSON_EQ16('['), JSON_EQ16(']'))),
+                                                  _mm_or_si128(JSON_EQ16(':'), JSON_EQ16(',')));
+                __m128i whitespace = _mm_or_si128(_mm_or_si128(JSON_EQ16(' '), JSON_EQ16('\t')),
+                                                  _mm_or_si128(JSON_EQ16('\n'), JSON_EQ16('\r')));
+                int shift = 16 * i;
+                m.quote |= uint64_t(uint32_t(_mm_movemask_epi8(JSON_EQ16('"')))) << shift;
+                m.backslash |= uint64_t(uint32_t(_mm_movemask_epi8(JSON_EQ16('\\')))) << shift;
+                m.structural |= uint64_t(uint32_t(_mm_movemask_epi8(structural))) << shift;
+                m.whitespace |= uint64_t(uint32_t(_mm_movemask_epi8(whitespace))) << shift;
+#undef JSON_EQ16
+            }
+            return m;
+        }
+
+        /* 函数名称: classify_avx2
+         * 功能描述: 每次比较 32 个字节，2 次得到一个 64 字节块的位图。仅在运行时检测到 AVX2 时调用。
+         */
+        __attribute__((target("avx2"))) inline auto classify_avx2(const char *p) -> BlockMasks
+        {
+            BlockMasks m{0, 0, 0, 0};
+            for (int i = 0; i < 2; i++)
+            {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32 * i));
+#define JSON_EQ32(c) _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c))
+                __m256i structural = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(JSON_EQ32('{'), JSON_EQ32('}')),
+                                                                     _mm256_or_si256(JSON_EQ32('['), JSON_EQ32(']'))),
+                                                     _mm256_or_si256(JSON_EQ32(':'), JSON_EQ32(',')));
+                __m256i whitespace = _mm256_or_si256(_mm256_or_si256(JSON_EQ32(' '), JSON_EQ32('\t')),
+                                                     _mm256_or_si256(JSON_EQ32('\n'), JSON_EQ32('\r')));
+                int shift = 32 * i;
+                m.quote |= uint64_t(uint32_t(_mm256_movemask_epi8(JSON_EQ32('"')))) << shift;
+                m.backslash |= uint64_t(uint32_t(_mm256_movemask_epi8(JSON_EQ32('\\')))) << shift;
+                m.structural |= uint64_t(uint32_t(_mm256_movemask_epi8(structural))) << shift;
+                m.whitespace |= uint64_t(uint32_t(_mm256_movemask_epi8(whitespace))) << shift;
+#undef JSON_EQ32
+            }
+            return m;
+        }
+#endif
+
+        /* 函数名称: best_kernel
+         * 功能描述: 运行时检测 CPU 支持的指令集，选出最快的可用内核（结果只计算一次）。
+         */
+        inline auto best_kernel() -> Kernel
+        {
+#ifdef JSON_HAS_X86_SIMD
+            static const Kernel k = __builtin_cpu_supports("avx2")   ? Kernel::AVX2
+                                    : __builtin_cpu_supports("sse2") ? Kernel::SSE2
+                                                                     : Kernel::Scalar;
+            return k;
+#else
+            return Kernel::Scalar;
+#endif
+        }
+
+        /* 函数名称: prefix_xor
+         * 功能描述: 计算位图的前缀异或，即第 i 位等于第 0..i 位的异或。
+         *           对引号位图求前缀异或即可得到“位于字符串内部”的区域。
+         */
+        inline auto prefix_xor(uint64_t x) -> uint64_t
+        {
+            x ^= x << 1;
+            x ^= x << 2;
+            x ^= x << 4;
+            x ^= x << 8;
+            x ^= x << 16;
+            x ^= x << 32;
+            return x;
+        }
+
+        /* 函数名称: find_escaped
+         * 功能描述: 找出被反斜杠转义的字符。反斜杠在实际数据中很少出现，
+         *           因此这里直接逐位遍历，无反斜杠的块只付出一次判断的代价。
+         * 参数:
+         *     - backslash: 本块的反斜杠位图
+         *     - carry: 上一块最后一个字符是否为未被转义的反斜杠（会被更新）
+         * 返回值:
+         *     - uint64_t（被转义字符的位图）
+         */
+        inline auto find_escaped(uint64_t backslash, uint64_t &carry) -> uint64_t
+        {
+            if (!backslash && !carry)
+            {
+                return 0;
+            }
+            uint64_t escaped = carry;   // 上一块末尾的反斜杠转义了本块第一个字符
+            backslash &= ~carry;        // 被转义的反斜杠本身不再转义别的字符
+            carry = 0;
+            while (backslash)
+            {
+                int i = __builtin_ctzll(backslash);
+                if (i == 63)
+                {
+                    carry = 1; // 转义作用延续到下一块
+                    break;
+                }
+                escaped |= uint64_t{1} << (i + 1);
+                backslash &= ~(uint64_t{3} << i); // 跳过当前反斜杠以及被它转义的字符
+            }
+            return escaped;
+        }
 
-    /*
-     * 类名: JsonGenerator
-     * 描述: 此类提供了生成 JSON 字符串的方法，根据输入的节点生成相应的 JSON 格式字符串。
-     */
-    class JsonGenerator
-    {
-    public:
         /*
-         * 函数名: generate
-         * 参数: node - 要生成 JSON 字符串的节点
-         * 返回值: 一个字符串，包含了生成的 JSON 数据
-         * 描述: 根据节点生成相应的 JSON 字符串。支持各种类型的节点，如 Null、Bool、Int、Float、String、Array 和 Object。
+         * 结构体: StructuralIndex
+         * 描述: 保存一份 JSON 文本中所有结构位置的有序偏移数组。
+         *       包括：字符串外的 {}[]:,、每个字符串的起止引号、每个标量的第一个字节。
          */
-        static auto generate(const Node &node) -> std::string
+        struct StructuralIndex
         {
-            // 使用 std::visit 遍历节点的值，并根据值的类型选择适当的生成函数
-            return std::visit(
-                [](auto &&arg) -> std::string // 使用 Lambda 表达式处理不同类型的节点值
+            std::vector<uint32_t> positions; ///< 结构位置（升序）
+
+            /* 函数名称: build
+             * 功能描述: 对整个输入按 64 字节块分类并展开成位置数组。
+             * 参数:
+             *     - json_str: 输入文本
+             *     - kernel: 使用的分类内核（默认运行时选择最快的）
+             * 返回值:
+             *     - bool（字符串未闭合或输入超过 4GB 时返回 false）
+             */
+            auto build(std::string_view json_str, Kernel kernel = best_kernel()) -> bool
+            {
+                positions.clear();
+                if (json_str.size() >= UINT32_MAX)
                 {
-                    using T = std::decay_t<decltype(arg)>;
-                    if constexpr (std::is_same_v<T, Null>)
-                    {
-                        return "null"; // 如果节点值是 Null 类型，返回 "null"
-                    }
-                    else if constexpr (std::is_same_v<T, Bool>)
-                    {
-                        return arg ? "true" : "false"; // 如果节点值是 Bool 类型，返回 "true" 或 "false"
-                    }
-                    else if constexpr (std::is_same_v<T, Int>)
-                    {
-                        return std::to_string(arg); // 如果节点值是 Int 类型，将其转换为字符串并返回
-                    }
-                    else if constexpr (std::is_same_v<T, Float>)
-                    {
-                        return std::to_string(arg); // 如果节点值是 Float 类型，将其转换为字符串并返回
-                    }
-                    else if constexpr (std::is_same_v<T, String>)
+                    return false; // 偏移使用 32 位存储
+                }
+                positions.reserve(json_str.size() / 4 + 16);
+
+                uint64_t escape_carry = 0; // 跨块的反斜杠状态
+                uint64_t in_string = 0;    // 上一块结束时是否在字符串内部（全 0 或全 1）
+                uint64_t scalar_carry = 0; // 上一块最后一个字节是否属于标量
+                char tail[64];             // 最后一个不足 64 字节的块，用空格补齐
+
+                for (size_t base = 0; base < json_str.size(); base += 64)
+                {
+                    const char *p = json_str.data() + base;
+                    if (json_str.size() - base < 64)
                     {
-                        return generate_string(arg); // 如果节点值是 String 类型，调用 generate_string 函数生成 JSON 字符串
+                        std::memset(tail, ' ', sizeof(tail));
+                        std::memcpy(tail, p, json_str.size() - base);
+                        p = tail;
                     }
-                    else if constexpr (std::is_same_v<T, Array>)
+
+                    BlockMasks m;
+                    switch (kernel)
                     {
-                        return generate_array(arg); // 如果节点值是 Array 类型，调用 generate_array 函数生成 JSON 数组字符串
+#ifdef JSON_HAS_X86_SIMD
+                    case Kernel::AVX2:
+                        m = classify_avx2(p);
+                        break;
+                    case Kernel::SSE2:
+                        m = classify_sse2(p);
+                        break;
+#endif
+                    default:
+                        m = classify_scalar(p);
+                        break;
                     }
-                    else if constexpr (std::is_same_v<T, Object>)
+
+                    uint64_t quote = m.quote & ~find_escaped(m.backslash, escape_carry);
+                    uint64_t string_mask = prefix_xor(quote) ^ in_string; // 开引号到闭引号之前
+                    in_string = uint64_t(int64_t(string_mask) >> 63);
+
+                    uint64_t scalar = ~(m.structural | m.whitespace | m.quote) & ~string_mask;
+                    uint64_t scalar_start = scalar & ~((scalar << 1) | scalar_carry);
+                    scalar_carry = scalar >> 63;
+
+                    uint64_t bits = (m.structural & ~string_mask) | quote | scalar_start;
+                    while (bits)
                     {
-                        return generate_object(arg); // 如果节点值是 Object 类型，调用 generate_object 函数生成 JSON 对象字符串
+                        positions.push_back(uint32_t(base + __builtin_ctzll(bits)));
+                        bits &= bits - 1;
                     }
-                },
-                node.value);
+                }
+                return in_string == 0; // 字符串必须闭合
+            }
+        };
+
+        /* 函数名称: find_special_scalar
+         * 功能描述: 逐字节查找字符串内容中第一个需要特殊处理的字节：引号、反斜杠或控制字符（< 0x20）。
+         * 返回值: 该字节的下标；没有时返回 n。
+         */
+        inline auto find_special_scalar(const char *p, size_t n) -> size_t
+        {
+            static constexpr auto special = []
+            {
+                std::array<bool, 256> t{};
+                for (int c = 0; c < 0x20; c++)
+                    t[c] = true;
+                t['"'] = t['\\'] = true;
+                return t;
+            }();
+            for (size_t i = 0; i < n; i++)
+            {
+                if (special[static_cast<unsigned char>(p[i])])
+                    return i;
+            }
+            return n;
         }
 
-        /*
-         * 函数名: generate_string
-         * 参数: str - 要生成 JSON 字符串的字符串
-         * 返回值: 一个字符串，包含了生成的 JSON 字符串
-         * 描述: 根据输入的字符串生成相应的 JSON 字符串。字符串会被包裹在双引号中。
+#ifdef JSON_HAS_X86_SIMD
+        /* 函数名称: find_special_sse2
+         * 功能描述: 每次比较 16 个字节；v <= 0x1F 用无符号 min 判断。
+         *           readable 为从 p 起可以安全读取的字节数（不小于 n）：只要够一次加载，就允许读过 n，
+         *           因此后面还有文本时短字符串一次比较即可完成；不够时剩余部分逐字节处理，不会越界读取。
          */
-        static auto generate_string(const String &str) -> std::string
+        __attribute__((target("sse2"))) inline auto find_special_sse2(const char *p, size_t n, size_t readable) -> size_t
         {
-            std::string json_str = "\""; // 在字符串前后添加双引号
-            json_str += str;             // 将输入的字符串追加到 JSON 字符串中
-            json_str += '"';
-            return json_str;
+            const __m128i quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\'), control = _mm_set1_epi8(0x1F);
+            size_t i = 0;
+            for (; i < n && readable - i >= 16; i += 16)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+                __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                           _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+                uint32_t mask = uint32_t(_mm_movemask_epi8(hit));
+                if (mask)
+                    return std::min(n, i + size_t(__builtin_ctz(mask)));
+            }
+            return i >= n ? n : i + find_special_scalar(p + i, n - i);
         }
 
-        /*
-         * 函数名: generate_array
-         * 参数: array - 要生成 JSON 字符串的数组
-         * 返回值: 一个字符串，包含了生成的 JSON 数组字符串
-         * 描述: 根据输入的数组生成相应的 JSON 数组字符串。数组中的每个元素都会被递归生成其对应的 JSON 字符串。
+        /* 函数名称: find_special_avx2
+         * 功能描述: 每次比较 32 个字节，剩余部分交给 SSE2 版本。
          */
-        static auto generate_array(const Array &array) -> std::string
+        __attribute__((target("avx2"))) inline auto find_special_avx2(const char *p, size_t n, size_t readable) -> size_t
         {
-            std::string json_str = "["; // 在数组前添加左方括号
-            for (const auto &node : array)
+            const __m256i quote = _mm256_set1_epi8('"'), backslash = _mm256_set1_epi8('\\'), control = _mm256_set1_epi8(0x1F);
+            size_t i = 0;
+            for (; i < n && readable - i >= 32; i += 32)
             {
-                json_str += generate(node); // 对数组中的每个元素递归调用 generate 函数生成 JSON 字符串，并追加到结果字符串中
-                json_str += ',';            // 在元素之间添加逗号分隔
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+                __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)),
+                                              _mm256_cmpeq_epi8(_mm256_min_epu8(v, control), v));
+                uint32_t mask = uint32_t(_mm256_movemask_epi8(hit));
+                if (mask)
+                    return std::min(n, i + size_t(__builtin_ctz(mask)));
             }
-            if (!array.empty())
-                json_str.pop_back(); // 移除最后一个元素后面的逗号
-            json_str += ']';         // 在数组后添加右方括号
-            return json_str;
+            return i >= n ? n : i + find_special_sse2(p + i, n - i, readable - i);
         }
+#endif
 
-        /*
-         * 函数名: generate_object
-         * 参数: object - 要生成 JSON 字符串的对象
-         * 返回值: 一个字符串，包含了生成的 JSON 对象字符串
-         * 描述: 根据输入的对象生成相应的 JSON 对象字符串。对象中的每个键值对都会被递归生成其对应的 JSON 字符串。
+        /* 函数名称: find_special
+         * 功能描述: 字符串内核：在 [p, p + n) 中找出第一个引号、反斜杠或控制字符，之前的字节可以整段复制。
+         *           readable（不小于 n）为可以安全读取的字节数，见 find_special_sse2。
+         * 返回值: 该字节的下标；没有时返回 n。
          */
-        static auto generate_object(const Object &object) -> std::string
+        inline auto find_special(const char *p, size_t n, size_t readable, Kernel kernel = best_kernel()) -> size_t
         {
-            std::string json_str = "{"; // 在对象前添加左花括号
-            for (const auto &[key, node] : object)
+            switch (kernel)
             {
-                json_str += generate_string(key); // 生成键的 JSON 字符串，并追加到结果字符串中
-                json_str += ':';                  // 键值对之间添加冒号分隔
-                json_str += generate(node);       // 递归调用 generate 函数生成值的 JSON 字符串，并追加到结果字符串中
-                json_str += ',';                  // 键值对之间添加逗号分隔
+#ifdef JSON_HAS_X86_SIMD
+            case Kernel::AVX2:
+                // 不超过 16 字节（大多数键）时一次 SSE2 比较即可，还省去一次无法内联的调用
+                return n <= 16 ? find_special_sse2(p, n, readable) : find_special_avx2(p, n, readable);
+            case Kernel::SSE2:
+                return find_special_sse2(p, n, readable);
+#endif
+            default:
+                return find_special_scalar(p, n);
             }
-            if (!object.empty())
-                json_str.pop_back(); // 移除最后一个键值对后面的逗号
-            json_str += '}';         // 在对象后添加右花括号
-            return json_str;
         }
-    };
 
-    /*
-     * 函数名: generate
-     * 参数: node - 要生成 JSON 字符串的节点
-     * 返回值: 一个字符串，包含了生成的 JSON 数据
-     * 描述: 调用 JsonGenerator 类的静态方法 generate，生成给定节点的 JSON 字符串，并返回结果。
-     */
+        inline auto find_special(const char *p, size_t n) -> size_t { return find_special(p, n, n); }
+
+        /* 函数名称: validate_utf8_scalar
+         * 功能描述: 逐个码点校验 UTF-8：拒绝截断的序列、多余的后续字节、过长编码、代理码点和超过 U+10FFFF 的码点。
+         *           连续 8 个 ASCII 字节一次跳过。
+         */
+        inline auto validate_utf8_scalar(const char *s, size_t n) -> bool
+        {
+            const auto *p = reinterpret_cast<const unsigned char *>(s);
+            size_t i = 0;
+            while (i < n)
+            {
+                if (n - i >= 8)
+                {
+                    uint64_t word;
+                    std::memcpy(&word, p + i, sizeof(word));
+                    if (!(word & 0x8080808080808080ull))
+                    {
+                        i += 8;
+                        continue;
+                    }
+                }
+                unsigned char c = p[i];
+                if (c < 0x80)
+                {
+                    i++;
+                    continue;
+                }
+                size_t len;
+                uint32_t cp;
+                if ((c & 0xE0) == 0xC0)
+                    len = 2, cp = c & 0x1F;
+                else if ((c & 0xF0) == 0xE0)
+                    len = 3, cp = c & 0x0F;
+                else if ((c & 0xF8) == 0xF0)
+                    len = 4, cp = c & 0x07;
+                else
+                    return false; // 孤立的后续字节或 0xF8 以上
+                if (n - i < len)
+                    return false;
+                for (size_t k = 1; k < len; k++)
+                {
+                    if ((p[i + k] & 0xC0) != 0x80)
+                        return false;
+                    cp = (cp << 6) | (p[i + k] & 0x3F);
+                }
+                static constexpr uint32_t min_cp[5] = {0, 0, 0x80, 0x800, 0x10000}; // 各长度下不算过长编码的最小码点
+                if (cp < min_cp[len] || cp > 0x10FFFF || (cp >= 0xD800 && cp < 0xE000))
+                    return false;
+                i += len;
+            }
+            return true;
+        }
+
+#ifdef JSON_HAS_X86_SIMD
+        /* 把 16 项查找表复制到两个 128 位通道中（vpshufb 在每个通道内独立查表） */
+        __attribute__((target("avx2"))) inline auto table16(const uint8_t (&t)[16]) -> __m256i
+        {
+            return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(t)));
+        }
+
+        /* 输入前移 N 个字节：结果的前 N 个字节取自上一块的末尾 */
+        template <int N>
+        __attribute__((target("avx2"))) inline auto prev_bytes(__m256i input, __m256i prev) -> __m256i
+        {
+            return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+        }
+
+        /* 每个字节的高 4 位 */
+        __attribute__((target("avx2"))) inline auto high_nibble(__m256i v) -> __m256i
+        {
+            return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+        }
+
+        /* 函数名称: utf8_errors_avx2
+         * 功能描述: 查表法（Keiser & Lemire）校验 32 个字节：用前一字节的高、低 4 位和当前字节的高 4 位各查一张表，
+         *           三者相与后非零的位即为该字节对上的错误（截断、多余后续字节、过长、代理、超出范围）；
+         *           再用前两、三个字节判断哪些位置必须是 3、4 字节序列的后续字节。返回非零字节表示有错误。
+         */
+        __attribute__((target("avx2"))) inline auto utf8_errors_avx2(__m256i input, __m256i prev) -> __m256i
+        {
+            constexpr uint8_t too_short = 1 << 0;      // 11______ 0_______ 或 11______ 11______
+            constexpr uint8_t too_long = 1 << 1;       // 0_______ 10______
+            constexpr uint8_t overlong_3 = 1 << 2;     // 11100000 100_____
+            constexpr uint8_t too_large = 1 << 3;      // 11110100 1001____ 等（> U+10FFFF）
+            constexpr uint8_t surrogate = 1 << 4;      // 11101101 101_____
+            constexpr uint8_t overlong_2 = 1 << 5;     // 1100000_ 10______
+            constexpr uint8_t too_large_1000 = 1 << 6; // 11110101 1000____ 等
+            constexpr uint8_t overlong_4 = 1 << 6;     // 11110000 1000____
+            constexpr uint8_t two_conts = 1 << 7;      // 10______ 10______
+            constexpr uint8_t carry = too_short | too_long | two_conts;
+            static constexpr uint8_t byte_1_high[16] = {
+                too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long, // 0___ ASCII
+                two_conts, two_conts, two_conts, two_conts,                                     // 10__ 后续字节
+                too_short | overlong_2,                                                         // 1100
+                too_short,                                                                      // 1101
+                too_short | overlong_3 | surrogate,                                             // 1110
+                too_short | too_large | too_large_1000 | overlong_4,                            // 1111
+            };
+            static constexpr uint8_t byte_1_low[16] = {
+                carry | overlong_3 | overlong_2 | overlong_4, // ____0000
+                carry | overlong_2,                           // ____0001
+                carry,
+                carry,
+                carry | too_large,                  // ____0100
+                carry | too_large | too_large_1000, // ____0101
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000, // ____1___
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000 | surrogate, // ____1101
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+            };
+            static constexpr uint8_t byte_2_high[16] = {
+                too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short, // 0___
+                too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,           // 1000
+                too_long | overlong_2 | two_conts | overlong_3 | too_large,                             // 1001
+                too_long | overlong_2 | two_conts | surrogate | too_large,                              // 1010
+                too_long | overlong_2 | two_conts | surrogate | too_large,                              // 1011
+                too_short, too_short, too_short, too_short,                                             // 11__
+            };
+            __m256i prev1 = prev_bytes<1>(input, prev);
+            __m256i special = _mm256_and_si256(
+                _mm256_and_si256(_mm256_shuffle_epi8(table16(byte_1_high), high_nibble(prev1)),
+                                 _mm256_shuffle_epi8(table16(byte_1_low), _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)))),
+                _mm256_shuffle_epi8(table16(byte_2_high), high_nibble(input)));
+            // 只有 111_____ 之后的第二个字节、1111____ 之后的第三个字节减去后仍 >= 0x80
+            __m256i third = _mm256_subs_epu8(prev_bytes<2>(input, prev), _mm256_set1_epi8(char(0xE0 - 0x80)));
+            __m256i fourth = _mm256_subs_epu8(prev_bytes<3>(input, prev), _mm256_set1_epi8(char(0xF0 - 0x80)));
+            __m256i must_be_continuation = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(char(0x80)));
+            return _mm256_xor_si256(must_be_continuation, special);
+        }
+
+        /* 函数名称: validate_utf8_avx2
+         * 功能描述: 每次校验 32 个字节；全 ASCII 的块只检查上一块末尾是否留下了未完成的序列。
+         *           最后不足 32 字节的部分补零后按同样方式处理，不会越界读取。
+         */
+        __attribute__((target("avx2"))) inline auto validate_utf8_avx2(const char *p, size_t n) -> bool
+        {
+            // 块末尾 3 个字节分别不能是 4、3、2 字节序列的首字节（否则序列延续到下一块）
+            static constexpr uint8_t max_tail[32] = {
+                255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1};
+            const __m256i max = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(max_tail));
+            __m256i error = _mm256_setzero_si256(), prev = _mm256_setzero_si256(), incomplete = _mm256_setzero_si256();
+            char tail[32] = {};
+            for (size_t i = 0; i < n; i += 32)
+            {
+                const char *block = p + i;
+                if (n - i < 32)
+                {
+                    std::memcpy(tail, block, n - i);
+                    block = tail;
+                }
+                __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+                if (_mm256_movemask_epi8(input) == 0)
+                {
+                    error = _mm256_or_si256(error, incomplete);
+                    incomplete = _mm256_setzero_si256();
+                }
+                else
+                {
+                    error = _mm256_or_si256(error, utf8_errors_avx2(input, prev));
+                    incomplete = _mm256_subs_epu8(input, max);
+                }
+                prev = input;
+            }
+            error = _mm256_or_si256(error, incomplete);
+            return _mm256_testz_si256(error, error);
+        }
+#endif
+
+        /* 函数名称: validate_utf8
+         * 功能描述: 检查 s 是否为合法的 UTF-8。AVX2 可用时使用向量化的查表算法，否则逐码点校验。
+         */
+        inline auto validate_utf8(std::string_view s, Kernel kernel = best_kernel()) -> bool
+        {
+#ifdef JSON_HAS_X86_SIMD
+            if (kernel == Kernel::AVX2)
+                return validate_utf8_avx2(s.data(), s.size());
+#endif
+            return validate_utf8_scalar(s.data(), s.size());
+        }
+    }
+
+    /* 函数名称: parse_hex4
+     * 功能描述: 解析 4 位十六进制数字（\uXXXX 中的 XXXX）。
+     * 返回值: 成功时返回码元，失败时返回 -1。
+     */
+    inline auto parse_hex4(const char *p) -> int32_t
+    {
+        int32_t v = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            char c = p[i];
+            int d = c >= '0' && c <= '9'   ? c - '0'
+                    : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                    : c >= 'A' && c <= 'F' ? c - 'A' + 10
+                                           : -1;
+            if (d < 0)
+                return -1;
+            v = v * 16 + d;
+        }
+        return v;
+    }
+
+    /* 函数名称: encode_utf8
+     * 功能描述: 把一个 Unicode 码点编码为 UTF-8 写入 out。
+     * 返回值: 写入的字节数。
+     */
+    inline auto encode_utf8(uint32_t cp, char *out) -> size_t
+    {
+        if (cp < 0x80)
+        {
+            out[0] = char(cp);
+            return 1;
+        }
+        if (cp < 0x800)
+        {
+            out[0] = char(0xC0 | (cp >> 6));
+            out[1] = char(0x80 | (cp & 0x3F));
+            return 2;
+        }
+        if (cp < 0x10000)
+        {
+            out[0] = char(0xE0 | (cp >> 12));
+            out[1] = char(0x80 | ((cp >> 6) & 0x3F));
+            out[2] = char(0x80 | (cp & 0x3F));
+            return 3;
+        }
+        out[0] = char(0xF0 | (cp >> 18));
+        out[1] = char(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = char(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = char(0x80 | (cp & 0x3F));
+        return 4;
+    }
+
+    /* 函数名称: unescape
+     * 功能描述: 把含转义序列的字符串内容解码到 out。解码结果不会比原文长，out 至少需要 raw.size() 字节。
+     *           支持 \" \\ \/ \b \f \n \r \t 以及 \uXXXX（含代理对，输出 UTF-8）。
+     *           两个转义之间不需要处理的字节由 simd::find_special 定位后整段复制。
+     * 参数:
+     *     - raw: 引号之间的原始内容
+     *     - out: 输出缓冲区
+     * 返回值:
+     *     - std::optional<size_t>（解码后的长度；遇到非法转义或未转义的控制字符时返回空 optional）
+     */
+    inline auto unescape(std::string_view raw, char *out) -> std::optional<size_t>
+    {
+        size_t n = 0;
+        size_t i = 0;
+        for (;;)
+        {
+            size_t run = simd::find_special(raw.data() + i, raw.size() - i);
+            std::memcpy(out + n, raw.data() + i, run);
+            n += run;
+            i += run;
+            if (i == raw.size())
+                return n;
+            if (raw[i] != '\\' || ++i >= raw.size())
+                return {}; // 控制字符必须转义
+            switch (raw[i++])
+            {
+            case '"':
+            case '\\':
+            case '/':
+                out[n++] = raw[i - 1];
+                break;
+            case 'b':
+                out[n++] = '\b';
+                break;
+            case 'f':
+                out[n++] = '\f';
+                break;
+            case 'n':
+                out[n++] = '\n';
+                break;
+            case 'r':
+                out[n++] = '\r';
+                break;
+            case 't':
+                out[n++] = '\t';
+                break;
+            case 'u':
+            {
+                if (raw.size() - i < 4) // 'u' 之后需要 4 位十六进制数字
+                    return {};
+                int32_t cp = parse_hex4(raw.data() + i);
+                if (cp < 0)
+                    return {};
+                i += 4;
+                if (cp >= 0xD800 && cp < 0xDC00) // 高代理，后面必须紧跟 \u 低代理
+                {
+                    if (raw.size() - i < 6 || raw[i] != '\\' || raw[i + 1] != 'u')
+                        return {};
+                    int32_t lo = parse_hex4(raw.data() + i + 2);
+                    if (lo < 0xDC00 || lo >= 0xE000)
+                        return {};
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    i += 6;
+                }
+                else if (cp >= 0xDC00 && cp < 0xE000)
+                {
+                    return {}; // 孤立的低代理
+                }
+                n += encode_utf8(uint32_t(cp), out + n);
+                break;
+            }
+            default:
+                return {};
+            }
+        }
+    }
+
+    /*
+     * 命名空间: number
+     * 描述: 数字解析内核。完整支持 JSON 数字语法（负号、小数、e/E 与 +/- 指数），
+     *       整数部分按 8 位一组用 SWAR 累加，int64 精确解析、溢出时转为 double；
+     *       浮点数依次尝试 Clinger 快速路径和 Eisel–Lemire 算法，二者都无法确定时才退回 std::from_chars。
+     *       全程不分配内存、不抛异常。
+     */
+    namespace number
+    {
+        /* 解析结果的类型 */
+        enum class Kind : uint8_t
+        {
+            Error,
+            Int,
+            Float,
+        };
+
+        /* 解析结果：end 指向数字之后的第一个字符 */
+        struct Parsed
+        {
+            Kind kind = Kind::Error;
+            const char *end = nullptr;
+            Int i = 0;
+            Float f = 0;
+        };
+
+        /* 函数名称: is_eight_digits
+         * 功能描述: 判断以小端序装入的 8 个字节是否全是 '0'~'9'。
+         */
+        inline auto is_eight_digits(uint64_t v) -> bool
+        {
+            return !(((v + 0x4646464646464646ULL) | (v - 0x3030303030303030ULL)) & 0x8080808080808080ULL);
+        }
+
+        /* 函数名称: parse_eight_digits
+         * 功能描述: SWAR：用三次乘法把 8 个 ASCII 数字转换成整数。
+         */
+        inline auto parse_eight_digits(uint64_t v) -> uint32_t
+        {
+            const uint64_t mask = 0x000000FF000000FFULL;
+            const uint64_t mul1 = 0x000F424000000064ULL; // 100 + (1000000 << 32)
+            const uint64_t mul2 = 0x0000271000000001ULL; // 1 + (10000 << 32)
+            v -= 0x3030303030303030ULL;
+            v = (v * 10) + (v >> 8); // 相邻两位合成 0~99
+            v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+            return uint32_t(v);
+        }
+
+        /* 函数名称: read8
+         * 功能描述: 以小端序读取 8 个字节。
+         */
+        inline auto read8(const char *p) -> uint64_t
+        {
+            uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        /* 函数名称: scan_digits
+         * 功能描述: 把 [p, end) 开头的连续数字累加到 mantissa（溢出部分由调用方根据位数处理），返回数字之后的位置。
+         */
+        inline auto scan_digits(const char *p, const char *end, uint64_t &mantissa) -> const char *
+        {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            while (end - p >= 8 && is_eight_digits(read8(p)))
+            {
+                mantissa = mantissa * 100000000 + parse_eight_digits(read8(p));
+                p += 8;
+            }
+#endif
+            while (p < end && unsigned(*p - '0') < 10)
+            {
+                mantissa = mantissa * 10 + unsigned(*p - '0');
+                p++;
+            }
+            return p;
+        }
+
+        constexpr int smallest_power = -342; ///< 小于 1e-342 的值一律下溢为 0
+        constexpr int largest_power = 308;   ///< 大于 1e308 的值一律上溢为无穷
+
+        /* 128 位的 5^q 近似值（最高位为 1），hi 为高 64 位 */
+        struct Power128
+        {
+            uint64_t hi;
+            uint64_t lo;
+        };
+
+        /* 函数名称: power_table
+         * 功能描述: 首次使用时用大整数运算生成 5^q（q ∈ [-342, 308]）的 128 位近似表：
+         *           q >= 0 时截断 5^q；q < 0 时取 floor(2^b / 5^-q) + 1 再截断，与 Eisel–Lemire 论文中的表一致。
+         */
+        inline auto power_table() -> const std::vector<Power128> &
+        {
+            static const std::vector<Power128> table = []
+            {
+                using Big = std::vector<uint32_t>; // 小端序的 32 位分段
+                auto bit_length = [](const Big &x) -> int
+                {
+                    for (int i = int(x.size()) - 1; i >= 0; i--)
+                        if (x[i])
+                            return i * 32 + 32 - __builtin_clz(x[i]);
+                    return 0;
+                };
+                auto mul_small = [](Big &x, uint32_t m)
+                {
+                    uint64_t carry = 0;
+                    for (auto &limb : x)
+                    {
+                        uint64_t v = uint64_t(limb) * m + carry;
+                        limb = uint32_t(v);
+                        carry = v >> 32;
+                    }
+                    if (carry)
+                        x.push_back(uint32_t(carry));
+                };
+                auto div_small = [](Big &x, uint32_t d)
+                {
+                    uint64_t rem = 0;
+                    for (int i = int(x.size()) - 1; i >= 0; i--)
+                    {
+                        uint64_t cur = (rem << 32) | x[i];
+                        x[i] = uint32_t(cur / d);
+                        rem = cur % d;
+                    }
+                };
+                auto add_one = [](Big &x)
+                {
+                    for (auto &limb : x)
+                        if (++limb != 0)
+                            return;
+                    x.push_back(1);
+                };
+                auto top128 = [&](const Big &x) -> Power128 // 取最高 128 位（截断）
+                {
+                    int shift = bit_length(x) - 128;
+                    auto bit = [&](int i) -> uint64_t
+                    {
+                        i += shift;
+                        if (i < 0 || i / 32 >= int(x.size()))
+                            return 0;
+                        return (x[i / 32] >> (i % 32)) & 1;
+                    };
+                    Power128 r{0, 0};
+                    for (int i = 0; i < 64; i++)
+                    {
+                        r.lo |= bit(i) << i;
+                        r.hi |= bit(i + 64) << i;
+                    }
+                    return r;
+                };
+                auto pow5 = [&](int n)
+                {
+                    Big x{1};
+                    for (; n >= 13; n -= 13)
+                        mul_small(x, 1220703125u); // 5^13
+                    for (; n > 0; n--)
+                        mul_small(x, 5);
+                    return x;
+                };
+
+                std::vector<Power128> t;
+                t.reserve(largest_power - smallest_power + 1);
+                for (int q = smallest_power; q <= largest_power; q++)
+                {
+                    if (q >= 0)
+                    {
+                        t.push_back(top128(pow5(q)));
+                        continue;
+                    }
+                    int z = bit_length(pow5(-q));            // 最小的 z 使得 2^z >= 5^-q
+                    int b = q >= -27 ? z + 127 : 2 * z + 128; // 分子的位数，保证商至少有 128 位
+                    Big x(size_t(b / 32 + 1), 0);
+                    x[b / 32] = uint32_t{1} << (b % 32);
+                    for (int n = -q; n > 0; n -= 13)
+                        div_small(x, n >= 13 ? 1220703125u : uint32_t(pow5(n)[0]));
+                    add_one(x);
+                    t.push_back(top128(x));
+                }
+                return t;
+            }();
+            return table;
+        }
+
+        /* 函数名称: mul128
+         * 功能描述: 64 位乘 64 位，返回 128 位结果的高、低两半。
+         */
+        inline void mul128(uint64_t a, uint64_t b, uint64_t &hi, uint64_t &lo)
+        {
+#ifdef __SIZEOF_INT128__
+            unsigned __int128 r = (unsigned __int128)a * b;
+            hi = uint64_t(r >> 64);
+            lo = uint64_t(r);
+#else
+            uint64_t a_lo = uint32_t(a), a_hi = a >> 32, b_lo = uint32_t(b), b_hi = b >> 32;
+            uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+            uint64_t mid = (ll >> 32) + uint32_t(lh) + uint32_t(hl);
+            lo = (mid << 32) | uint32_t(ll);
+            hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+        }
+
+        /* 函数名称: eisel_lemire
+         * 功能描述: 计算 w * 10^q 的正确舍入 double。结果可能不唯一（极少数接近中点的情况）时返回 false。
+         */
+        inline auto eisel_lemire(uint64_t w, int64_t q, bool negative, Float &out) -> bool
+        {
+            if (w == 0 || q < smallest_power)
+            {
+                out = negative ? -0.0 : 0.0;
+                return true;
+            }
+            if (q > largest_power)
+            {
+                return false; // 交给回退路径处理上溢
+            }
+            const Power128 &factor = power_table()[size_t(q - smallest_power)];
+            int64_t exponent = (((152170 + 65536) * q) >> 16) + 1024 + 63; // floor(q * log2(10)) + 偏置
+            int lz = __builtin_clzll(w);
+            w <<= lz;
+            uint64_t upper, lower;
+            mul128(w, factor.hi, upper, lower);
+            if ((upper & 0x1FF) == 0x1FF && lower + w < lower)
+            {
+                // 只用高 64 位不足以确定结果，再乘上低 64 位
+                uint64_t hi2, lo2;
+                mul128(w, factor.lo, hi2, lo2);
+                uint64_t middle = lower + hi2;
+                if (middle < lower)
+                    upper++;
+                if (middle + 1 == 0 && (upper & 0x1FF) == 0x1FF && lo2 + w < lo2)
+                    return false;
+                lower = middle;
+            }
+            uint64_t upperbit = upper >> 63;
+            uint64_t mantissa = upper >> (upperbit + 9);
+            lz += int(1 ^ upperbit);
+            if (lower == 0 && (upper & 0x1FF) == 0 && (mantissa & 3) == 1)
+                return false; // 恰好位于两个 double 的中点附近
+            mantissa += mantissa & 1;
+            mantissa >>= 1;
+            if (mantissa >= (uint64_t{1} << 53))
+            {
+                mantissa = uint64_t{1} << 52;
+                lz--;
+            }
+            mantissa &= ~(uint64_t{1} << 52);
+            int64_t real_exponent = exponent - lz;
+            if (real_exponent < 1 || real_exponent > 2046)
+                return false; // 次正规数或上溢，交给回退路径
+            mantissa |= uint64_t(real_exponent) << 52;
+            mantissa |= uint64_t(negative) << 63;
+            std::memcpy(&out, &mantissa, sizeof(out));
+            return true;
+        }
+
+        /* 函数名称: parse
+         * 功能描述: 从 [p, end) 解析一个 JSON 数字。超出 double 范围的数（如 1e400）无法原样写回，按错误处理；
+         *           下溢的数舍入为 0。
+         * 返回值: Parsed（kind 为 Error 时表示语法错误或上溢）
+         */
+        inline auto parse(const char *p, const char *end) -> Parsed
+        {
+            static const Float exact_powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                                 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+            Parsed r;
+            const char *start = p;
+            bool negative = p < end && *p == '-';
+            p += negative;
+
+            // 整数部分：单个 0，或以 1~9 开头的数字串
+            uint64_t mantissa = 0;
+            const char *int_begin = p;
+            if (p < end && *p == '0')
+                p++;
+            else if (p < end && unsigned(*p - '1') < 9)
+                p = scan_digits(p, end, mantissa);
+            else
+                return r;
+            if (p < end && unsigned(*p - '0') < 10)
+                return r; // 不允许前导零
+            int64_t digits = p - int_begin;
+
+            // 小数部分
+            int64_t exponent = 0;
+            bool is_float = false;
+            if (p < end && *p == '.')
+            {
+                is_float = true;
+                const char *frac_begin = ++p;
+                p = scan_digits(p, end, mantissa);
+                if (p == frac_begin)
+                    return r; // 小数点后至少要有一位数字
+                exponent = -(p - frac_begin);
+                digits += p - frac_begin;
+            }
+
+            // 指数部分
+            if (p < end && (*p == 'e' || *p == 'E'))
+            {
+                is_float = true;
+                p++;
+                bool exp_negative = p < end && *p == '-';
+                if (p < end && (*p == '-' || *p == '+'))
+                    p++;
+                if (p >= end || unsigned(*p - '0') >= 10)
+                    return r; // 指数至少要有一位数字
+                int64_t exp_value = 0;
+                for (; p < end && unsigned(*p - '0') < 10; p++)
+                {
+                    if (exp_value < 0x10000) // 更大的指数反正会上溢或下溢
+                        exp_value = exp_value * 10 + (*p - '0');
+                }
+                exponent += exp_negative ? -exp_value : exp_value;
+            }
+            r.end = p;
+
+            // 超过 19 位有效数字时 mantissa 已经溢出；先扣掉不影响数值的前导零再判断
+            bool exact = digits <= 19;
+            if (!exact)
+            {
+                int64_t leading = 0;
+                for (const char *q = int_begin; q < p && (*q == '0' || *q == '.'); q++)
+                    leading += *q == '0';
+                exact = digits - leading <= 19;
+            }
+
+            if (!is_float && exact)
+            {
+                // 整数：精确落在 int64 范围内时直接返回
+                if (mantissa <= uint64_t(INT64_MAX) + negative)
+                {
+                    r.kind = Kind::Int;
+                    r.i = negative ? Int(0 - mantissa) : Int(mantissa);
+                    return r;
+                }
+            }
+
+            r.kind = Kind::Float;
+            if (exact)
+            {
+                // Clinger 快速路径：尾数和 10 的幂都能被 double 精确表示，一次乘除即可正确舍入
+                if (mantissa <= (uint64_t{1} << 53) && exponent >= -22 && exponent <= 22)
+                {
+                    Float d = Float(mantissa);
+                    d = exponent < 0 ? d / exact_powers[-exponent] : d * exact_powers[exponent];
+                    r.f = negative ? -d : d;
+                    return r;
+                }
+                if (eisel_lemire(mantissa, exponent, negative, r.f))
+                    return r;
+            }
+
+            // 回退：超长尾数、次正规数或中点附近的极少数情况
+            auto [ptr, ec] = std::from_chars(start, p, r.f);
+            if (ec == std::errc::result_out_of_range)
+            {
+                if (exponent + digits > 0)
+                    r.kind = Kind::Error; // 上溢：写出时 inf 只能变成 null，拒绝比静默改变数值更好
+                else
+                    r.f = negative ? -0.0 : 0.0;
+            }
+            else if (ec != std::errc{} || ptr != p)
+            {
+                r.kind = Kind::Error;
+            }
+            return r;
+        }
+    }
+
+    /*
+     * 类名: NodePool
+     * 描述: 解析结果的回收池，由 Document 持有。recycle() 把一棵树拆开：数组、对象（连同其哈希索引）
+     *       和超出短字符串优化长度的字符串被清空后按文档顺序留在池中，容量不释放；解析时再按同样的顺序取用。
+     *       因此反复解析形状相同的文档时，第二次起每个容器和长字符串都拿到恰好够用的缓冲区，不再分配内存。
+     *       形状不同时也只会在缓冲区不够大时扩容，容量只增不减。
+     */
+    class NodePool
+    {
+    public:
+        /* 函数名称: recycle
+         * 功能描述: 把 root 下的整棵树拆回池中，root 变为 null。显式栈遍历，调用栈不随深度增长。
+         */
+        void recycle(Node &root)
+        {
+            compact();
+            size_t first_array = arrays.size(), first_object = objects.size();
+            work.push_back(&root);
+            while (!work.empty())
+            {
+                Node *node = work.back();
+                work.pop_back();
+                node->invalidate();
+                if (auto array = std::get_if<Array>(&node->value))
+                {
+                    auto &kept = arrays.emplace_back(std::move(*array));
+                    for (auto it = kept.rbegin(); it != kept.rend(); ++it) // 逆序入栈，出栈即文档顺序
+                        work.push_back(&*it);
+                }
+                else if (auto object = std::get_if<Object>(&node->value))
+                {
+                    auto &kept = objects.emplace_back(std::move(*object));
+                    for (auto &member : kept)
+                        keep(keys, member.first.take_text());
+                    for (auto it = kept.end(); it != kept.begin();)
+                        work.push_back(&(--it)->second);
+                }
+                else if (auto string = std::get_if<String>(&node->value))
+                {
+                    keep(strings, std::move(*string));
+                }
+                node->value = Null{};
+            }
+            // 子节点已经全部拆空，清空容器只析构 null 和标量，保留容量
+            for (size_t i = first_array; i < arrays.size(); i++)
+                arrays[i].clear();
+            for (size_t i = first_object; i < objects.size(); i++)
+                objects[i].clear();
+        }
+
+        /* 取一个空数组 */
+        auto array() -> Array { return next_array < arrays.size() ? std::move(arrays[next_array++]) : Array{}; }
+
+        /* 取一个空对象 */
+        auto object() -> Object { return next_object < objects.size() ? std::move(objects[next_object++]) : Object{}; }
+
+        /* 取一个内容为 text 的字符串 */
+        auto string(std::string_view text) -> String
+        {
+            if (text.size() <= short_capacity || next_string >= strings.size())
+                return String{text};
+            String s = std::move(strings[next_string++]);
+            s.assign(text);
+            return s;
+        }
+
+        /* 取一个长度为 size 的字符串缓冲区（内容未定义），由调用方写入 */
+        auto string(size_t size) -> String
+        {
+            if (size <= short_capacity || next_string >= strings.size())
+                return String(size, '\0');
+            String s = std::move(strings[next_string++]);
+            s.resize(size);
+            return s;
+        }
+
+        /* 取一个文本为 text 的（不驻留的）键 */
+        auto key(std::string_view text) -> Key
+        {
+            if (text.size() <= short_capacity || next_key >= keys.size())
+                return Key{String{text}};
+            String s = std::move(keys[next_key++]);
+            s.assign(text);
+            return Key{std::move(s)};
+        }
+
+    private:
+        static inline const size_t short_capacity = String().capacity(); ///< 不超过它的字符串不分配，无需回收
+
+        std::vector<Array> arrays;
+        std::vector<Object> objects;
+        std::vector<String> strings, keys;
+        size_t next_array = 0, next_object = 0, next_string = 0, next_key = 0; ///< 下一个要取用的下标
+        std::vector<Node *> work;                                              ///< recycle 的遍历栈
+
+        static void keep(std::vector<String> &pool, String &&s)
+        {
+            if (s.capacity() > short_capacity)
+                pool.push_back(std::move(s));
+        }
+
+        /* 丢掉已被取走的（移动后为空的）条目，未取用的留在池首 */
+        void compact()
+        {
+            arrays.erase(arrays.begin(), arrays.begin() + next_array);
+            objects.erase(objects.begin(), objects.begin() + next_object);
+            strings.erase(strings.begin(), strings.begin() + next_string);
+            keys.erase(keys.begin(), keys.begin() + next_key);
+            next_array = next_object = next_string = next_key = 0;
+        }
+    };
+
+    /* 默认的最大嵌套层数。各解析器都以它为上限，深度再大的输入会干净地失败 */
+    inline constexpr size_t default_max_depth = 1024;
+
+    struct JsonParser
+    {
+        /* 解析 JSON 字符串的视图 */
+        std::string_view json_str;
+        /* 当前解析位置 */
+        size_t pos = 0;
+        /* 结构索引（可选）；为空时退回逐字节扫描 */
+        const uint32_t *index = nullptr;
+        /* 结构索引中的元素个数 */
+        size_t index_size = 0;
+        /* 结构索引中当前所在的下标 */
+        size_t cursor = 0;
+        /* 键池（可选）；设置后对象的键被驻留为共享句柄，不再逐个分配 */
+        KeyPool *keys = nullptr;
+        /* 允许的最大嵌套层数，超过时解析失败 */
+        size_t max_depth = default_max_depth;
+        /* 最近一次失败是否因为嵌套超过 max_depth */
+        bool depth_exceeded = false;
+        /* 解码对象键的缓冲区，跨成员复用 */
+        String key_scratch{};
+        /* 回收池（可选）；设置后容器和字符串从池中取用已有的容量 */
+        NodePool *pool = nullptr;
+        /* parse_tree 中尚未闭合的数组和对象，跨多次解析复用 */
+        std::vector<Node *> open{};
+
+        /* 函数名称: start
+         * 功能描述: 开始解析新的输入：重置位置和错误状态，并构建结构索引，之后的解析在索引位置间跳转；
+         *           构建失败时退回逐字节扫描。各缓冲区的容量保留。
+         */
+        void start(std::string_view json, simd::StructuralIndex &structurals)
+        {
+            if constexpr (stats::enabled)
+            {
+                stats::counters().parse.bytes += json.size();
+            }
+            json_str = json;
+            pos = cursor = 0;
+            depth_exceeded = false;
+            bool indexed;
+            {
+                stats::Timer timer(&stats::ParseCounters::stage1_ns, false);
+                indexed = structurals.build(json_str);
+            }
+            index = indexed ? structurals.positions.data() : nullptr;
+            index_size = indexed ? structurals.positions.size() : 0;
+        }
+
+        /* 函数名称: seek_index
+         * 功能描述: 在结构索引中前进到第一个不小于 from 的位置。
+         * 返回值:
+         *     - size_t（该结构位置；索引耗尽时返回 json_str.size()）
+         */
+        auto seek_index(size_t from) -> size_t
+        {
+            while (cursor < index_size && index[cursor] < from)
+            {
+                ++cursor;
+            }
+            return cursor < index_size ? index[cursor] : json_str.size();
+        }
+
+        /* JSON 的四个空白字符 */
+        static auto is_whitespace(char c) -> bool { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+        /* 函数名称: parse_whitespace
+         * 功能描述: 跳过 JSON 字符串中的空白字符：只有空格、制表符、换行和回车（与结构索引一致，不含 \v、\f）。
+         * 参数:
+         *     - 无（使用成员变量 json_str 和 pos）
+         * 返回值:
+         *     - void（不返回任何值，直接修改 pos 的值）
+         */
+        void parse_whitespace()
+        {
+            stats::Timer timer(&stats::ParseCounters::whitespace_ns);
+            if (index) // 有结构索引时直接跳到下一个结构位置
+            {
+                pos = seek_index(pos);
+                return;
+            }
+            // 循环条件：当前位置小于 JSON 字符串的长度，并且当前字符是空白字符
+            while (pos < json_str.size() && is_whitespace(json_str[pos]))
+            {
+                ++pos; // 如果是空白字符，则 pos 自增，跳过该字符
+            }
+        }
+
+        /* 函数名称: at_delimiter
+         * 功能描述: 判断位置 at 是否可以结束一个字面量或数字：只能是分隔符、空白或输入结束。
+         *           有结构索引时下一次跳过空白会直接跳到下一个结构位置，因此必须在这里拒绝 "truex"、"12ab" 这类输入。
+         */
+        auto at_delimiter(size_t at) const -> bool
+        {
+            return at >= json_str.size() || std::memchr(",]} \t\n\r", json_str[at], 7);
+        }
+
+        /* 函数名称: at_end
+         * 功能描述: 判断当前位置之后是否只剩空白，各解析模式在根值之后用它拒绝 "1 2"、"{} x" 这类输入。
+         *           有结构索引时 parse_whitespace 会越过非结构字符，因此直接检查剩余的文本。
+         */
+        auto at_end() const -> bool
+        {
+            return json_str.find_first_not_of(" \t\n\r", pos) == json_str.npos;
+        }
+
+        /* 函数名称: parse_null
+         * 功能描述: 从当前位置开始解析 JSON 字符串中的 null 值。
+         * 参数:
+         *     - 无（使用成员变量 json_str 和 pos）
+         * 返回值:
+         *     - std::optional<Value>（解析成功时返回 Null 类型的值，失败时返回空 optional）
+         */
+        auto parse_null() -> std::optional<Value>
+        {
+            // 判断从当前位置开始的 4 个字符是否为 "null"，且其后是分隔符
+            if (json_str.substr(pos, 4) == "null" && at_delimiter(pos + 4))
+            {
+                pos += 4;      // 如果是，则 pos 增加 4，跳过 "null"
+                return Null{}; // 并返回 Null 类型的值
+            }
+            return {}; // 如果不是 "null"，返回空 optional
+        }
+
+        /* 函数名称: parse_true
+         * 功能描述: 从当前位置开始解析 JSON 字符串中的 true 值。
+         * 参数:
+         *     - 无（使用成员变量 json_str 和 pos）
+         * 返回值:
+         *     - std::optional<Value>（解析成功时返回 true，失败时返回空 optional）
+         */
+        auto parse_true() -> std::optional<Value>
+        {
+            // 判断从当前位置开始的 4 个字符是否为 "true"，且其后是分隔符
+            if (json_str.substr(pos, 4) == "true" && at_delimiter(pos + 4))
+            {
+                pos += 4;    // 如果是，则 pos 增加 4，跳过 "true"
+                return true; // 并返回 true
+            }
+            return {}; // 如果不是 "true"，返回空 optional
+        }
+
+        /* 函数名称: parse_false
+         * 功能描述: 从当前位置开始解析 JSON 字符串中的 false 值。
+         * 参数:
+         *     - 无（使用成员变量 json_str 和 pos）
+         * 返回值:
+         *     - std::optional<Value>（解析成功时返回 false，失败时返回空 optional）
+         */
+        auto parse_false() -> std::optional<Value>
+        {
+            // 判断从当前位置开始的 5 个字符是否为 "false"，且其后是分隔符
+            if (json_str.substr(pos, 5) == "false" && at_delimiter(pos + 5))
+            {
+                pos += 5;     // 如果是，则 pos 增加 5，跳过 "false"
+                return false; // 并返回 false
+            }
+            return {}; // 如果不是 "false"，返回空 optional
+        }
+
+        /**
+         * 函数名称: parse_number
+         * 功能描述:
+         *     解析 JSON 字符串中的数字。这个函数从当前位置（pos）开始，按完整的 JSON 数字语法
+         *     （可选负号、整数部分、小数部分、e/E 指数及其 +/- 号）交给 number::parse 内核解析，
+         *     不复制、不抛异常。能被 int64 精确表示的整数返回 Int，其余返回 Float。
+         * 参数: 无
+         * 返回值:
+         *     std::optional<Value> - 如果解析成功，返回一个包含数字（整数或浮点数）的 Value 对象；
+         *                            如果数字格式错误或其后紧跟非分隔字符，则返回一个空的 optional 对象。
+         */
+        auto parse_number() -> std::optional<Value>
+        {
+            stats::Timer timer(&stats::ParseCounters::number_ns);
+            const char *begin = json_str.data() + pos;
+            const char *end = json_str.data() + json_str.size();
+            auto number = number::parse(begin, end);
+            if (number.kind == number::Kind::Error)
+            {
+                return {}; // 数字格式错误
+            }
+            // 数字之后只能是分隔符、空白或输入结束，否则（如 "12ab"）视为错误
+            if (!at_delimiter(size_t(number.end - json_str.data())))
+            {
+                return {};
+            }
+            pos = size_t(number.end - json_str.data()); // 更新解析器的当前位置为数字的结束位置
+            if (number.kind == number::Kind::Int)
+            {
+                return number.i; // 返回整数
+            }
+            return number.f; // 返回浮点数
+        }
+
+        /**
+         * 函数名称: scan_string
+         * 功能描述:
+         *     从开引号处找到对应的闭引号（跳过被反斜杠转义的引号），返回字符串内容在源缓冲区中的原始范围，
+         *     并报告其中是否含有转义序列。解析位置更新到闭引号之后。
+         * 参数:
+         *     escaped - 输出参数，内容中含有反斜杠或控制字符（需要经 unescape 解码或报错）时置为 true
+         * 返回值:
+         *     std::optional<std::string_view> - 字符串内容的视图；字符串未闭合时返回空的 optional 对象。
+         */
+        auto scan_string(bool &escaped) -> std::optional<std::string_view>
+        {
+            size_t begin = pos + 1; // 跳过开始的双引号(")
+            size_t endpos = begin;
+            escaped = false;
+            if (index) // 有结构索引时，闭引号就是下一个结构位置
+            {
+                endpos = seek_index(begin);
+                escaped = endpos < json_str.size() &&
+                          simd::find_special(json_str.data() + begin, endpos - begin, json_str.size() - begin) != endpos - begin;
+            }
+            else
+            {
+                // 在引号、反斜杠和控制字符之间整段跳过，反斜杠之后的字符一律跳过
+                for (;;)
+                {
+                    endpos += simd::find_special(json_str.data() + endpos, json_str.size() - endpos);
+                    if (endpos >= json_str.size() || json_str[endpos] == '"')
+                        break;
+                    escaped = true; // 反斜杠需要解码，控制字符留给解码时报错
+                    if (json_str[endpos] == '\\')
+                    {
+                        endpos++;
+                    }
+                    endpos++;
+                }
+            }
+            if (endpos >= json_str.size())
+            {
+                return {}; // 字符串未闭合
+            }
+            pos = endpos + 1; // 更新解析器位置到结束双引号之后
+            return json_str.substr(begin, endpos - begin);
+        }
+
+        /**
+         * 函数名称: parse_string
+         * 功能描述:
+         *     从当前位置开始解析 JSON 字符串中的字符串值。这个函数寻找以双引号(")开始和结束的文本，
+         *     解码其中的转义序列，将结果作为字符串值返回。不含转义的内容整段复制。
+         * 参数: 无
+         * 返回值:
+         *     std::optional<Value> - 如果成功解析字符串，返回包含该字符串的 Value 对象；
+         *                            字符串未闭合、含非法转义或未转义的控制字符时返回空的 optional 对象。
+         */
+        auto parse_string() -> std::optional<Value>
+        {
+            stats::Timer timer(&stats::ParseCounters::string_ns);
+            bool escaped;
+            auto raw = scan_string(escaped);
+            if (!raw)
+            {
+                return {};
+            }
+            if (!escaped)
+            {
+                return pool ? pool->string(*raw) : String{*raw}; // 返回解析得到的字符串
+            }
+            String str = pool ? pool->string(raw->size()) : String(raw->size(), '\0');
+            auto len = unescape(*raw, str.data());
+            if (!len)
+            {
+                return {};
+            }
+            str.resize(*len);
+            return str;
+        }
+
+        /**
+         * 函数名称: parse_scalar
+         * 功能描述:
+         *     根据当前字符解析一个非容器的值：null, true, false, 数字或字符串。
+         * 参数: 无
+         * 返回值:
+         *     std::optional<Value> - 解析到的值；格式错误时返回空的 optional 对象。
+         */
+        auto parse_scalar() -> std::optional<Value>
+        {
+            switch (json_str[pos])
+            {
+            case 'n': // 如果是 'n'，尝试解析 null
+                return parse_null();
+            case 't': // 如果是 't'，尝试解析 true
+                return parse_true();
+            case 'f': // 如果是 'f'，尝试解析 false
+                return parse_false();
+            case '"': // 如果是 '"'，解析字符串
+                return parse_string();
+            default: // 默认情况下，尝试解析数字
+                return parse_number();
+            }
+        }
+
+        /**
+         * 函数名称: open_slot
+         * 功能描述:
+         *     在容器中为下一个元素开辟位置：数组直接追加一个 Null 元素；对象先解析键和冒号，
+         *     再插入（或覆盖，重复的键以最后一次为准）一个 Null 成员。调用方随后把值写进返回的位置。
+         * 参数:
+         *     container - 正在填充的数组或对象
+         * 返回值:
+         *     Node* - 新元素的位置；键格式错误时返回 nullptr。
+         */
+        auto open_slot(Node &container) -> Node *
+        {
+            if (auto array = std::get_if<Array>(&container.value))
+            {
+                return &array->emplace_back();
+            }
+            auto &obj = std::get<Object>(container.value);
+            parse_whitespace();
+            if (pos >= json_str.size() || json_str[pos] != '"')
+            {
+                return nullptr; // 键必须是字符串
+            }
+            if constexpr (stats::enabled)
+            {
+                stats::counters().parse.keys++;
+            }
+            std::optional<std::string_view> raw;
+            bool escaped;
+            {
+                stats::Timer timer(&stats::ParseCounters::string_ns);
+                raw = scan_string(escaped);
+            }
+            if (!raw)
+            {
+                return nullptr;
+            }
+            parse_whitespace();
+            if (pos >= json_str.size() || json_str[pos] != ':')
+            {
+                return nullptr; // 键之后必须是冒号
+            }
+            pos++;
+            std::string_view key = *raw;
+            if (escaped) // 先解码再驻留或构造，含转义的键与等价的未转义键是同一个键
+            {
+                stats::Timer timer(&stats::ParseCounters::string_ns, false);
+                key_scratch.resize(raw->size());
+                auto len = unescape(*raw, key_scratch.data());
+                if (!len)
+                {
+                    return nullptr;
+                }
+                key = std::string_view{key_scratch.data(), *len};
+            }
+            if (keys) // 有键池时直接驻留键文本，不构造 String
+            {
+                return &obj.insert_or_assign(Key{keys->intern(key)}, Node{}).first->second;
+            }
+            return &obj.insert_or_assign(pool ? pool->key(key) : Key{String{key}}, Node{}).first->second;
+        }
+
+        /**
+         * 函数名称: parse_tree
+         * 功能描述:
+         *     非递归的解析核心。尚未闭合的容器保存在一个显式栈中（每层一个指针），值直接写进它在树中的最终位置，
+         *     因此栈帧大小与嵌套深度无关，可以在很小的栈（如协程、纤程）上解析任意深的输入。
+         *     同一时刻只有栈顶容器会被追加元素，更外层容器中的元素不会被移动，栈中的指针始终有效。
+         *     嵌套超过 max_depth 层时解析失败并置 depth_exceeded。
+         * 参数:
+         *     root - 接收解析结果的节点
+         * 返回值:
+         *     bool - 解析成功时返回 true；格式错误或嵌套过深时返回 false（root 的内容未定义）。
+         */
+        auto parse_tree(Node &root) -> bool
+        {
+            open.clear();
+            Node *slot = &root; // 下一个值要写入的位置
+            for (;;)
+            {
+                parse_whitespace();
+                if (pos >= json_str.size())
+                {
+                    return false; // 输入已结束，没有可解析的值
+                }
+                char c = json_str[pos];
+                if (c == '[' || c == '{')
+                {
+                    if (open.size() >= max_depth)
+                    {
+                        depth_exceeded = true;
+                        return false;
+                    }
+                    pos++; // 跳过开始的括号
+                    if (c == '[')
+                        slot->value = pool ? pool->array() : Array{};
+                    else
+                        slot->value = pool ? pool->object() : Object{};
+                    open.push_back(slot);
+                    stats::count_container(c == '[', open.size());
+                    parse_whitespace();
+                    if (pos >= json_str.size() || json_str[pos] != (c == '[' ? ']' : '}'))
+                    {
+                        slot = open_slot(*slot); // 非空容器：先解析第一个元素
+                        if (!slot)
+                        {
+                            return false;
+                        }
+                        continue;
+                    }
+                    pos++; // 空容器：跳过结束的括号，它本身就是一个完整的值
+                    open.pop_back();
+                }
+                else
+                {
+                    auto value = parse_scalar();
+                    if (!value)
+                    {
+                        return false;
+                    }
+                    stats::count_scalar(*value);
+                    slot->value = std::move(*value);
+                }
+
+                // 一个值已经完整：逐层处理其后的逗号或结束括号，直到需要解析下一个值
+                for (;;)
+                {
+                    if (open.empty())
+                    {
+                        return true; // 顶层值已闭合
+                    }
+                    Node &parent = *open.back();
+                    parse_whitespace();
+                    if (pos >= json_str.size())
+                    {
+                        return false; // 缺少结束的括号
+                    }
+                    char d = json_str[pos++];
+                    if (d == ',')
+                    {
+                        slot = open_slot(parent);
+                        if (!slot)
+                        {
+                            return false;
+                        }
+                        break;
+                    }
+                    if (d != (std::holds_alternative<Array>(parent.value) ? ']' : '}'))
+                    {
+                        return false; // 元素之后只能是逗号或与之匹配的结束括号
+                    }
+                    open.pop_back();
+                }
+            }
+        }
+
+        /**
+         * 函数名称: parse_value
+         * 功能描述:
+         *     从当前位置解析一个完整的 JSON 值（null, true, false, 数字, 字符串, 数组或对象），由 parse_tree 完成。
+         * 参数: 无
+         * 返回值:
+         *     std::optional<Value> - 解析到的值；如果没有匹配的类型或解析过程中发生错误，则返回空的 optional 对象。
+         */
+        auto parse_value() -> std::optional<Value>
+        {
+            Node root;
+            if (!parse_tree(root))
+            {
+                return {};
+            }
+            return std::move(root.value);
+        }
+
+        /**
+         * 函数名称: parse_into
+         * 功能描述:
+         *     先校验整个输入是合法的 UTF-8，再跳过任何前导的空白字符，然后把 JSON 文本中的值直接解析进 root。
+         *     值之后只允许空白：`1 2`、`{} x` 这类输入整体失败，而不是只返回第一个值。
+         * 参数:
+         *     root - 接收解析结果的节点，应为 null
+         * 返回值:
+         *     bool - 解析成功时返回 true；失败时返回 false（root 的内容未定义）。
+         */
+        auto parse_into(Node &root) -> bool
+        {
+            bool valid;
+            {
+                stats::Timer timer(&stats::ParseCounters::stage1_ns, false);
+                valid = simd::validate_utf8(json_str);
+            }
+            if (!valid) // 整个输入一次校验，字符串之外的非 ASCII 字节本来就是语法错误
+            {
+                return false;
+            }
+            parse_whitespace(); // 解析并跳过 JSON 文本前的任何空白字符
+            return parse_tree(root) && at_end(); // 值之后只允许空白
+        }
+
+        /**
+         * 函数名称: parse
+         * 功能描述:
+         *     这是解析 JSON 文本的高层次入口点函数，由 parse_into 解析出一个新的 Node 对象。
+         * 参数: 无
+         * 返回值:
+         *     std::optional<Node> - 如果解析成功，返回一个包含解析到的值的 Node 对象；
+         *                            如果解析过程中遇到错误，则返回空的 optional 对象。
+         */
+        auto parse() -> std::optional<Node>
+        {
+            Node root;
+            if (!parse_into(root))
+            {
+                return {}; // 返回空的 optional 对象，表示解析失败
+            }
+            return root;
+        }
+    };
+
+    /*
+     * 函数名: parser
+     * 参数: json_str - 包含 JSON 数据的 std::string_view
+     *       structurals - 结构索引的存储，跨多次调用复用可以避免重复分配
+     *       keys - 可选的键池，可在多次调用和多个线程之间共享
+     *       max_depth - 允许的最大嵌套层数，超过时解析失败
+     * 返回值: std::optional<Node>，一个可能包含解析后 JSON 数据的节点的可选对象
+     * 描述: 此函数接受一个 JSON 字符串，并尝试解析它。如果解析成功，则返回一个包含解析结果的节点；如果解析失败，则返回空的 std::optional。
+     */
+    auto parser(std::string_view json_str, simd::StructuralIndex &structurals, KeyPool *keys = nullptr,
+                size_t max_depth = default_max_depth) -> std::optional<Node>
+    {
+        stats::Section section(stats::Scope::Parse);
+
+        // 创建 JsonParser 对象，构建结构索引
+        JsonParser p;
+        p.keys = keys;
+        p.max_depth = max_depth;
+        p.start(json_str, structurals);
+
+        // 调用 JsonParser 的 parse() 方法进行解析，并返回解析结果
+        return p.parse();
+    }
+
+    /*
+     * 函数名: parser
+     * 参数: json_str - 包含 JSON 数据的 std::string_view
+     * 返回值: std::optional<Node>，一个可能包含解析后 JSON 数据的节点的可选对象
+     * 描述: 单次解析的便捷入口，结构索引用完即弃。需要反复解析时请使用上面复用 structurals 的重载。
+     */
+    auto parser(std::string_view json_str) -> std::optional<Node>
+    {
+        simd::StructuralIndex structurals;
+        return parser(json_str, structurals);
+    }
+
+    /*
+     * 类名: Document
+     * 描述: 可回收的解析结果，配合 Parser 在高频批量解析中使用。reset() 把当前的树拆回内部的回收池而不释放内存，
+     *       下一次 Parser::parse 从池中取用容器和字符串的容量；反复解析形状相同的文档时稳定后不再分配内存。
+     *       可移动，不可复制；需要真正释放内存时销毁或用一个新的 Document 覆盖它。
+     */
+    class Document
+    {
+    public:
+        Document() = default;
+        Document(const Document &) = delete;
+        Document &operator=(const Document &) = delete;
+        Document(Document &&) = default;
+        Document &operator=(Document &&) = default;
+
+        /* 解析结果的根，未解析或解析失败时为 null */
+        auto root() -> Node & { return tree; }
+        auto root() const -> const Node & { return tree; }
+
+        /* 函数名称: reset
+         * 功能描述: 清空文档，根变为 null，所有容量留在回收池中。
+         */
+        void reset() { pool.recycle(tree); }
+
+    private:
+        friend class Parser;
+
+        Node tree;
+        NodePool pool;
+    };
+
+    /*
+     * 类名: Parser
+     * 描述: 可长期持有的解析器。结构索引、未闭合容器栈和键解码缓冲区在多次 parse() 之间复用，
+     *       配合 Document 时解析结果的容量也被复用。一个 Parser 同一时刻只能被一个线程使用。
+     */
+    class Parser
+    {
+    public:
+        /*
+         * 参数: keys - 可选的键池，可在多个 Parser 和线程之间共享
+         *       max_depth - 允许的最大嵌套层数，超过时解析失败
+         */
+        explicit Parser(KeyPool *keys = nullptr, size_t max_depth = default_max_depth)
+        {
+            p.keys = keys;
+            p.max_depth = max_depth;
+        }
+
+        Parser(const Parser &) = delete;
+        Parser &operator=(const Parser &) = delete;
+
+        /*
+         * 函数名: parse
+         * 功能描述: 先 reset() 文档，再把 json_str 解析进去，容器和字符串优先使用文档回收池中的容量。
+         * 返回值: 解析成功时返回 true；失败时返回 false，文档被清空为 null
+         */
+        auto parse(std::string_view json_str, Document &doc) -> bool
+        {
+            stats::Section section(stats::Scope::Parse);
+            doc.reset();
+            p.pool = &doc.pool;
+            p.start(json_str, structurals);
+            bool ok = p.parse_into(doc.tree);
+            p.pool = nullptr;
+            if (!ok)
+            {
+                doc.reset(); // 丢弃解析了一半的树，容量仍然回收
+            }
+            return ok;
+        }
+
+        /*
+         * 函数名: parse
+         * 功能描述: 与 json::parser 相同，但复用本解析器的缓冲区；结果树是新分配的。
+         */
+        auto parse(std::string_view json_str) -> std::optional<Node>
+        {
+            stats::Section section(stats::Scope::Parse);
+            p.start(json_str, structurals);
+            return p.parse();
+        }
+
+        /* 最近一次失败是否因为嵌套超过 max_depth */
+        auto depth_exceeded() const -> bool { return p.depth_exceeded; }
+
+        /* 函数名称: reset
+         * 功能描述: 丢弃对上一次输入的引用和解析状态，各缓冲区的容量保留。
+         */
+        void reset()
+        {
+            p.json_str = {};
+            p.pos = p.cursor = 0;
+            p.index = nullptr;
+            p.index_size = 0;
+            p.depth_exceeded = false;
+            p.open.clear();
+            p.key_scratch.clear();
+            structurals.positions.clear();
+        }
+
+    private:
+        JsonParser p;
+        simd::StructuralIndex structurals;
+    };
+
+    /*
+     * 类名: MappedFile
+     * 描述: 以只读方式把整个文件映射进内存，并提示内核按顺序预读。
+     *       在不支持 mmap 的平台上退化为一次性读入内存。只可移动，不可复制。
+     */
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::string &path)
+        {
+#ifdef JSON_HAS_MMAP
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                return;
+            struct stat st;
+            if (::fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                return; // 取不到文件大小，视为打开失败
+            }
+            if (st.st_size > 0)
+            {
+                void *p = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED)
+                {
+                    // advice 是枚举值而不是位标志，两个提示必须分开设置
+                    ::madvise(p, size_t(st.st_size), MADV_SEQUENTIAL);
+                    ::madvise(p, size_t(st.st_size), MADV_WILLNEED);
+                    ptr = static_cast<const char *>(p);
+                    length = size_t(st.st_size);
+                }
+            }
+            else
+            {
+                opened = true; // 空文件：映射长度为 0 不合法，直接视为空内容
+            }
+            ::close(fd); // 映射建立后即可关闭文件描述符
+            opened = opened || ptr != nullptr;
+#else
+            std::ifstream fin(path, std::ios::binary);
+            if (!fin)
+                return;
+            std::stringstream ss;
+            ss << fin.rdbuf();
+            fallback = ss.str();
+            ptr = fallback.data();
+            length = fallback.size();
+            opened = true;
+#endif
+        }
+
+        ~MappedFile()
+        {
+#ifdef JSON_HAS_MMAP
+            if (ptr)
+                ::munmap(const_cast<char *>(ptr), length);
+#endif
+        }
+
+        MappedFile(MappedFile &&rhs) noexcept { swap(rhs); }
+        MappedFile &operator=(MappedFile &&rhs) noexcept
+        {
+            swap(rhs);
+            return *this;
+        }
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        /* 函数名称: data
+         * 功能描述: 返回整个文件内容的视图，只在 MappedFile 存活期间有效。
+         */
+        auto data() const -> std::string_view { return {ptr, length}; }
+
+        /* 文件是否成功打开 */
+        explicit operator bool() const { return opened; }
+
+    private:
+        void swap(MappedFile &rhs) noexcept
+        {
+            std::swap(ptr, rhs.ptr);
+            std::swap(length, rhs.length);
+            std::swap(opened, rhs.opened);
+#ifndef JSON_HAS_MMAP
+            std::swap(fallback, rhs.fallback);
+            ptr = fallback.data();
+            rhs.ptr = rhs.fallback.data();
+#endif
+        }
+
+        const char *ptr = nullptr; ///< 映射起始地址
+        size_t length = 0;         ///< 映射长度
+        bool opened = false;       ///< 文件是否成功打开
+#ifndef JSON_HAS_MMAP
+        std::string fallback; ///< 不支持 mmap 时的文件内容
+#endif
+    };
+
+    /*
+     * 函数名: parse_file
+     * 参数: path - JSON 文件路径
+     * 返回值: std::optional<Node>，文件无法打开或解析失败时为空
+     * 描述: 直接在文件的只读映射上解析，省去 ifstream -> stringstream -> std::string 的两次复制。
+     *       解析器的所有读取都以视图长度为界（结构索引对最后不足 64 字节的块做了补齐复制），不会越过映射末尾。
+     */
+    auto parse_file(const std::string &path) -> std::optional<Node>
+    {
+        MappedFile file(path);
+        if (!file)
+        {
+            return {};
+        }
+        return parser(file.data());
+    }
+
+    /*
+     * 命名空间: ondemand
+     * 描述: 按需访问模式。parse() 只构建结构索引并返回一个轻量的 Document，
+     *       doc["address"]["city"] 这样的访问只沿着路径前进：路过的兄弟值利用结构索引做括号配对跳过，
+     *       不构建任何 Node。字符串内容不会出现在结构索引中，因此跳过时只需数括号。
+     *       被跳过的部分不做完整的语法校验。
+     */
+    namespace ondemand
+    {
+        class Document;
+
+        /*
+         * 类名: Value
+         * 描述: 指向某个值的游标，只包含文档指针和该值在结构索引中的下标，可以随意按值传递。
+         *       访问失败时与 Node 一样抛出 std::runtime_error。
+         */
+        class Value
+        {
+        public:
+            Value(const Document *doc, size_t entry) : doc(doc), entry(entry) {}
+
+            /* 值的第一个字符：{ [ " t f n 或数字 */
+            inline auto first_char() const -> char;
+
+            auto is_object() const -> bool { return first_char() == '{'; }
+            auto is_array() const -> bool { return first_char() == '['; }
+            auto is_string() const -> bool { return first_char() == '"'; }
+            auto is_null() const -> bool { return first_char() == 'n'; }
+            auto is_bool() const -> bool { return first_char() == 't' || first_char() == 'f'; }
+            auto is_number() const -> bool { return first_char() == '-' || unsigned(first_char() - '0') < 10; }
+
+            inline auto operator[](std::string_view key) const -> Value;
+            inline auto operator[](size_t index) const -> Value;
+
+            inline auto get_bool() const -> Bool;
+            inline auto get_int() const -> Int;
+            inline auto get_double() const -> Float;
+            inline auto get_string() const -> String;
+            inline auto raw() const -> std::string_view;
+            inline auto to_node() const -> Node;
+
+            /*
+             * 类名: Iterator
+             * 描述: 依次访问数组元素或对象成员（对象时可用 key() 取得键）。越过最后一个元素后等于 end()。
+             */
+            class Iterator
+            {
+            public:
+                Iterator(const Document *doc, size_t entry, bool object) : doc(doc), entry(entry), object(object) {}
+                auto operator*() const -> Value { return Value{doc, object ? entry + 3 : entry}; }
+                inline auto key() const -> String;
+                inline auto raw_key() const -> std::string_view;
+                inline auto key_equals(std::string_view key) const -> bool;
+                inline auto operator++() -> Iterator &;
+                auto operator==(const Iterator &rhs) const -> bool { return entry == rhs.entry; }
+                auto operator!=(const Iterator &rhs) const -> bool { return entry != rhs.entry; }
+
+            private:
+                const Document *doc;
+                size_t entry; ///< 数组元素或对象键的结构下标，结束时为 npos
+                bool object;
+            };
+
+            inline auto begin() const -> Iterator;
+            auto end() const -> Iterator { return Iterator{doc, npos, is_object()}; }
+
+            static constexpr size_t npos = SIZE_MAX;
+
+        private:
+            const Document *doc; ///< 所属文档
+            size_t entry;        ///< 值在结构索引中的下标
+        };
+
+        /*
+         * 类名: Document
+         * 描述: 持有输入视图和结构索引。Value 指向 Document，因此创建 Value 之后不要移动 Document。
+         */
+        class Document
+        {
+        public:
+            std::string_view json;             ///< 输入文本（调用方保证其有效）
+            simd::StructuralIndex structurals; ///< 结构索引
+
+            /* 根值的游标 */
+            auto root() const -> Value { return Value{this, 0}; }
+            auto operator[](std::string_view key) const -> Value { return root()[key]; }
+            auto operator[](size_t index) const -> Value { return root()[index]; }
+
+            /* 结构下标 entry 处的字节偏移与字符 */
+            auto offset(size_t entry) const -> size_t
+            {
+                if (entry >= structurals.positions.size())
+                    throw std::runtime_error("unexpected end of input");
+                return structurals.positions[entry];
+            }
+            auto at(size_t entry) const -> char { return json[offset(entry)]; }
+
+            /* 函数名称: skip
+             * 功能描述: 返回紧跟在 entry 处整个值之后的结构下标。容器只需数括号，字符串占两个下标（开、闭引号）。
+             */
+            auto skip(size_t entry) const -> size_t
+            {
+                char c = at(entry);
+                if (c == '"')
+                    return entry + 2;
+                if (c != '{' && c != '[')
+                    return entry + 1;
+                const uint32_t *pos = structurals.positions.data();
+                size_t n = structurals.positions.size();
+                size_t depth = 1;
+                for (++entry; entry < n; ++entry)
+                {
+                    char d = json[pos[entry]];
+                    if (d == '{' || d == '[')
+                        ++depth;
+                    else if ((d == '}' || d == ']') && --depth == 0)
+                        return entry + 1;
+                }
+                throw std::runtime_error("unexpected end of input");
+            }
+
+            /* 函数名称: string_at
+             * 功能描述: 取出 entry 处字符串（开引号）的原始内容。
+             */
+            auto string_at(size_t entry) const -> std::string_view
+            {
+                size_t begin = offset(entry) + 1;
+                return json.substr(begin, offset(entry + 1) - begin);
+            }
+
+            /* 函数名称: parser_at
+             * 功能描述: 返回一个定位在 entry 处、共用本文档结构索引的 JsonParser，用来按与 DOM 相同的规则解析单个值。
+             */
+            auto parser_at(size_t entry) const -> JsonParser
+            {
+                JsonParser p{json};
+                p.index = structurals.positions.data();
+                p.index_size = structurals.positions.size();
+                p.cursor = entry;
+                p.pos = offset(entry);
+                return p;
+            }
+
+            /* 函数名称: decode_at
+             * 功能描述: 取出 entry 处字符串并解码转义。与 DOM 一样经 scan_string 和 unescape，
+             *           并校验 UTF-8：未转义的控制字符、非法转义和非法 UTF-8 都会失败。
+             * 异常: std::runtime_error 如果字符串不合法。
+             */
+            auto decode_at(size_t entry) const -> String
+            {
+                JsonParser p = parser_at(entry);
+                bool escaped;
+                auto raw = p.scan_string(escaped);
+                if (!raw || !simd::validate_utf8(*raw))
+                    throw std::runtime_error("invalid string");
+                if (!escaped)
+                    return String{*raw};
+                String out(raw->size(), '\0');
+                auto len = unescape(*raw, out.data());
+                if (!len)
+                    throw std::runtime_error("invalid string");
+                out.resize(*len);
+                return out;
+            }
+        };
+
+        inline auto Value::first_char() const -> char { return doc->at(entry); }
+
+        inline auto Value::begin() const -> Iterator
+        {
+            char c = first_char();
+            if (c != '{' && c != '[')
+                throw std::runtime_error("not a container");
+            char close = c == '{' ? '}' : ']';
+            return Iterator{doc, doc->at(entry + 1) == close ? npos : entry + 1, c == '{'};
+        }
+
+        inline auto Value::Iterator::key() const -> String { return doc->decode_at(entry); }
+
+        inline auto Value::Iterator::operator++() -> Iterator &
+        {
+            size_t next = doc->skip(object ? entry + 3 : entry); // 跳过当前值（对象时先越过键的两个引号和冒号）
+            entry = doc->at(next) == ',' ? next + 1 : npos;
+            return *this;
+        }
+
+        inline auto Value::Iterator::raw_key() const -> std::string_view { return doc->string_at(entry); }
+
+        /* 键是否等于 key：不含转义的键直接比较源文本，含转义时比较解码后的键（"a\\n" 与 "a\n" 不相等） */
+        inline auto Value::Iterator::key_equals(std::string_view key) const -> bool
+        {
+            std::string_view raw = raw_key();
+            if (raw.find('\\') == raw.npos)
+                return raw == key;
+            return this->key() == key;
+        }
+
+        /* 函数名称: operator[]
+         * 功能描述: 在对象中查找键，逐个比较键并用括号配对跳过不匹配成员的值。
+         * 异常: std::runtime_error 如果不是对象或键不存在。
+         */
+        inline auto Value::operator[](std::string_view key) const -> Value
+        {
+            if (!is_object())
+                throw std::runtime_error("not an object");
+            for (auto it = begin(); it != end(); ++it)
+            {
+                if (it.key_equals(key))
+                    return *it;
+            }
+            throw std::runtime_error("key not found");
+        }
+
+        /* 函数名称: operator[]
+         * 功能描述: 取数组的第 index 个元素，前面的元素整体跳过。
+         * 异常: std::runtime_error 如果不是数组或越界。
+         */
+        inline auto Value::operator[](size_t index) const -> Value
+        {
+            if (!is_array())
+                throw std::runtime_error("not an array");
+            for (auto it = begin(); it != end(); ++it, --index)
+            {
+                if (index == 0)
+                    return *it;
+            }
+            throw std::runtime_error("index out of range");
+        }
+
+        /* 标量的读取与 DOM 使用同一组 JsonParser 函数，其后紧跟多余字符（如 truex、12x）时同样失败 */
+        inline auto Value::get_bool() const -> Bool
+        {
+            char c = first_char();
+            if (c != 't' && c != 'f')
+                throw std::runtime_error("not a bool");
+            JsonParser p = doc->parser_at(entry);
+            if (!(c == 't' ? p.parse_true() : p.parse_false()))
+                throw std::runtime_error("invalid literal");
+            return c == 't';
+        }
+
+        inline auto Value::get_int() const -> Int
+        {
+            if (!is_number())
+                throw std::runtime_error("not an integer");
+            JsonParser p = doc->parser_at(entry);
+            auto n = p.parse_number();
+            if (!n)
+                throw std::runtime_error("invalid number");
+            if (auto i = std::get_if<Int>(&*n))
+                return *i;
+            throw std::runtime_error("not an integer");
+        }
+
+        inline auto Value::get_double() const -> Float
+        {
+            if (!is_number())
+                throw std::runtime_error("not a number");
+            JsonParser p = doc->parser_at(entry);
+            auto n = p.parse_number();
+            if (!n)
+                throw std::runtime_error("invalid number");
+            if (auto i = std::get_if<Int>(&*n))
+                return Float(*i);
+            return std::get<Float>(*n);
+        }
+
+        inline auto Value::get_string() const -> String
+        {
+            if (!is_string())
+                throw std::runtime_error("not a string");
+            return doc->decode_at(entry);
+        }
+
+        /* 函数名称: raw
+         * 功能描述: 返回该值在输入中的原始文本（字符串包含引号），不做解析。
+         */
+        inline auto Value::raw() const -> std::string_view
+        {
+            size_t begin = doc->offset(entry);
+            size_t end = begin;
+            char c = first_char();
+            if (c == '"')
+                end = doc->offset(entry + 1) + 1;
+            else if (c == '{' || c == '[')
+                end = doc->offset(doc->skip(entry) - 1) + 1;
+            else
+                while (end < doc->json.size() && !std::memchr(",]} \t\n\r", doc->json[end], 7))
+                    ++end;
+            return doc->json.substr(begin, end - begin);
+        }
+
+        /* 函数名称: to_node
+         * 功能描述: 把该值完整解析成 Node，解析器直接从该值的结构下标继续使用已有的索引。
+         * 异常: std::runtime_error 如果该值不是合法的 JSON。
+         */
+        inline auto Value::to_node() const -> Node
+        {
+            JsonParser p = doc->parser_at(entry);
+            auto value = p.parse_value();
+            if (!value)
+                throw std::runtime_error("invalid json");
+            return Node{std::move(*value)};
+        }
+
+        /*
+         * 函数名: parse
+         * 参数: json - 输入文本，必须在 doc 使用期间有效
+         *       doc - 文档存储，跨多次调用复用可以避免索引的重复分配
+         * 返回值: 根值的游标；结构索引无法构建（未闭合字符串等）或输入为空时为空
+         * 描述: 只构建结构索引，不做任何值的解析。
+         */
+        inline auto parse(std::string_view json, Document &doc) -> std::optional<Value>
+        {
+            doc.json = json;
+            if (!doc.structurals.build(json) || doc.structurals.positions.empty())
+                return {};
+            return doc.root();
+        }
+    }
+
+    /*
+     * 类名: Path
+     * 描述: 预编译的路径查询。支持 RFC 6901 JSON Pointer（"/sites/0/url"，~0 表示 ~，~1 表示 /）
+     *       和一个简单的 JSONPath 子集（$、.name、['name']、[n]、.* 与 [*]；不支持 .. 和过滤表达式）。
+     *       编译一次后可以反复对 Node 或原始文本求值；对原始文本求值时借助 ondemand 游标，
+     *       不匹配的子树只被括号配对跳过，不会构建 Node。
+     */
+    class Path
+    {
+    public:
+        /*
+         * 结构体: Step
+         * 描述: 路径中的一步。
+         */
+        struct Step
+        {
+            enum class Kind
+            {
+                Member,  ///< 按键取对象成员；指针中的数字记号同时可作数组下标
+                Index,   ///< 按下标取数组元素
+                Wildcard ///< 对象的所有成员或数组的所有元素
+            };
+            Kind kind = Kind::Member;
+            std::string key{};        ///< Member 的键
+            size_t index = SIZE_MAX;  ///< 数组下标；SIZE_MAX 表示不能作为下标
+        };
+
+        /* 函数名称: compile
+         * 功能描述: 以 '$' 开头的按 JSONPath 编译，否则按 JSON Pointer 编译。
+         * 返回值: 语法错误时为空
+         */
+        static auto compile(std::string_view expr) -> std::optional<Path>
+        {
+            return !expr.empty() && expr[0] == '$' ? from_jsonpath(expr) : from_pointer(expr);
+        }
+
+        /* 函数名称: from_pointer
+         * 功能描述: 编译 RFC 6901 JSON Pointer。空串表示整个文档。
+         */
+        static auto from_pointer(std::string_view expr) -> std::optional<Path>
+        {
+            Path path;
+            if (expr.empty())
+                return path;
+            if (expr[0] != '/')
+                return {};
+            size_t i = 1;
+            while (true)
+            {
+                size_t end = std::min(expr.find('/', i), expr.size());
+                Step step;
+                for (size_t j = i; j < end; j++)
+                {
+                    if (expr[j] != '~')
+                        step.key += expr[j];
+                    else if (j + 1 < end && (expr[j + 1] == '0' || expr[j + 1] == '1'))
+                        step.key += expr[++j] == '0' ? '~' : '/';
+                    else
+                        return {};
+                }
+                step.index = as_index(step.key);
+                path.steps.push_back(std::move(step));
+                if (end == expr.size())
+                    return path;
+                i = end + 1;
+            }
+        }
+
+        /* 函数名称: from_jsonpath
+         * 功能描述: 编译 JSONPath 子集，例如 $.sites[*].url、$['a b'][0]。
+         */
+        static auto from_jsonpath(std::string_view expr) -> std::optional<Path>
+        {
+            if (expr.empty() || expr[0] != '$')
+                return {};
+            Path path;
+            size_t i = 1;
+            while (i < expr.size())
+            {
+                Step step;
+                if (expr[i] == '.')
+                {
+                    size_t end = std::min(expr.find_first_of(".[", i + 1), expr.size());
+                    if (end == i + 1) // 空名字或 ..
+                        return {};
+                    step.key = std::string(expr.substr(i + 1, end - i - 1));
+                    if (step.key == "*")
+                        step.kind = Step::Kind::Wildcard;
+                    i = end;
+                }
+                else if (expr[i] == '[' && i + 1 < expr.size() && (expr[i + 1] == '\'' || expr[i + 1] == '"'))
+                {
+                    char quote = expr[i + 1];
+                    for (i += 2; i < expr.size() && expr[i] != quote; i++)
+                    {
+                        if (expr[i] == '\\' && i + 1 < expr.size())
+                            ++i;
+                        step.key += expr[i];
+                    }
+                    if (i + 1 >= expr.size() || expr[i + 1] != ']')
+                        return {};
+                    i += 2;
+                }
+                else if (expr[i] == '[')
+                {
+                    size_t end = expr.find(']', i);
+                    if (end == expr.npos)
+                        return {};
+                    std::string_view token = expr.substr(i + 1, end - i - 1);
+                    if (token == "*")
+                        step.kind = Step::Kind::Wildcard;
+                    else if ((step.index = as_index(token)) != SIZE_MAX)
+                        step.kind = Step::Kind::Index;
+                    else
+                        return {};
+                    i = end + 1;
+                }
+                else
+                {
+                    return {};
+                }
+                path.steps.push_back(std::move(step));
+            }
+            return path;
+        }
+
+        /* 函数名称: find
+         * 功能描述: 返回第一个匹配的节点，没有匹配时返回 nullptr。
+         */
+        auto find(const Node &root) const -> const Node *
+        {
+            const Node *found = nullptr;
+            visit(root, 0, [&](const Node &n)
+                  { found = &n; return false; });
+            return found;
+        }
+
+        /* 函数名称: evaluate
+         * 功能描述: 返回所有匹配节点的指针（按文档顺序），指针在 root 被修改前有效。
+         */
+        auto evaluate(const Node &root) const -> std::vector<const Node *>
+        {
+            std::vector<const Node *> out;
+            visit(root, 0, [&](const Node &n)
+                  { out.push_back(&n); return true; });
+            return out;
+        }
+
+        /* 函数名称: evaluate
+         * 功能描述: 对 ondemand 游标求值，返回所有匹配值的游标，调用方再按需取值或 to_node()。
+         */
+        auto evaluate(ondemand::Value root) const -> std::vector<ondemand::Value>
+        {
+            std::vector<ondemand::Value> out;
+            visit(root, 0, [&](ondemand::Value v)
+                  { out.push_back(v); return true; });
+            return out;
+        }
+
+        /* 函数名称: evaluate
+         * 功能描述: 直接对原始文本求值，doc 跨多次调用复用以避免索引的重复分配。
+         * 返回值: 文本无法建立结构索引时为空
+         */
+        auto evaluate(std::string_view json, ondemand::Document &doc) const -> std::optional<std::vector<ondemand::Value>>
+        {
+            auto root = ondemand::parse(json, doc);
+            if (!root)
+                return {};
+            return evaluate(*root);
+        }
+
+    private:
+        std::vector<Step> steps; ///< 编译后的步骤
+
+        /* 非负十进制整数且无前导零时返回其值，否则返回 SIZE_MAX */
+        static auto as_index(std::string_view token) -> size_t
+        {
+            if (token.empty() || token.size() > 18 || (token.size() > 1 && token[0] == '0'))
+                return SIZE_MAX;
+            size_t value = 0;
+            for (char c : token)
+            {
+                if (unsigned(c - '0') > 9)
+                    return SIZE_MAX;
+                value = value * 10 + size_t(c - '0');
+            }
+            return value;
+        }
+
+        /* 函数名称: visit
+         * 功能描述: 从第 step 步开始匹配 node，对每个匹配调用 emit；emit 返回 false 时停止。
+         * 返回值: false 表示已被 emit 叫停
+         */
+        template <class F>
+        auto visit(const Node &node, size_t step, F &&emit) const -> bool
+        {
+            if (step == steps.size())
+                return emit(node);
+            const Step &s = steps[step];
+            if (auto *obj = std::get_if<Object>(&node.value))
+            {
+                if (s.kind == Step::Kind::Wildcard)
+                {
+                    for (const auto &[key, child] : *obj)
+                        if (!visit(child, step + 1, emit))
+                            return false;
+                }
+                else if (s.kind == Step::Kind::Member)
+                {
+                    auto it = obj->find(s.key);
+                    if (it != obj->end())
+                        return visit(it->second, step + 1, emit);
+                }
+            }
+            else if (auto *arr = std::get_if<Array>(&node.value))
+            {
+                if (s.kind == Step::Kind::Wildcard)
+                {
+                    for (const auto &child : *arr)
+                        if (!visit(child, step + 1, emit))
+                            return false;
+                }
+                else if (s.index < arr->size())
+                {
+                    return visit((*arr)[s.index], step + 1, emit);
+                }
+            }
+            return true;
+        }
+
+        template <class F>
+        auto visit(ondemand::Value value, size_t step, F &&emit) const -> bool
+        {
+            if (step == steps.size())
+                return emit(value);
+            const Step &s = steps[step];
+            if (value.is_object())
+            {
+                if (s.kind == Step::Kind::Index)
+                    return true;
+                for (auto it = value.begin(); it != value.end(); ++it)
+                {
+                    if (s.kind == Step::Kind::Wildcard)
+                    {
+                        if (!visit(*it, step + 1, emit))
+                            return false;
+                        continue;
+                    }
+                    if (it.key_equals(s.key))
+                        return visit(*it, step + 1, emit);
+                }
+            }
+            else if (value.is_array())
+            {
+                if (s.kind != Step::Kind::Wildcard && s.index == SIZE_MAX)
+                    return true;
+                size_t i = 0;
+                for (auto it = value.begin(); it != value.end(); ++it, ++i)
+                {
+                    if (s.kind == Step::Kind::Wildcard)
+                    {
+                        if (!visit(*it, step + 1, emit))
+                            return false;
+                    }
+                    else if (i == s.index)
+                    {
+                        return visit(*it, step + 1, emit);
+                    }
+                }
+            }
+            return true;
+        }
+    };
+
+    /*
+     * 命名空间: tape
+     * 描述: 第二种 DOM 模式。整棵树被压平成一条“磁带”：一段连续的 64 位标记字数组，
+     *       外加一块字符串缓冲区，二者都从每次解析独占的 Arena 中切出。
+     *       只读视图 Element 提供与 Node 类似的访问接口；Arena 重置即可 O(1) 释放整棵树。
+     */
+    namespace tape
+    {
+        /*
+         * 类名: Arena
+         * 描述: 简单的单调分配器。内存按块申请，reset() 只把游标移回开头，
+         *       已申请的块留给下一次解析复用，不逐个释放。
+         */
+        class Arena
+        {
+        public:
+            /* 函数名称: allocate
+             * 功能描述: 从当前块中切出 bytes 字节（按 align 对齐），当前块不够时换到下一块或申请新块。
+             */
+            auto allocate(size_t bytes, size_t align = alignof(uint64_t)) -> void *
+            {
+                while (current < chunks.size())
+                {
+                    size_t offset = (used + align - 1) & ~(align - 1);
+                    if (offset + bytes <= chunks[current].size)
+                    {
+                        used = offset + bytes;
+                        return chunks[current].data.get() + offset;
+                    }
+                    ++current; // 当前块放不下，尝试之前留下的下一块
+                    used = 0;
+                }
+                size_t size = std::max(bytes + align, chunks.empty() ? size_t{64 << 10} : chunks.back().size * 2);
+                chunks.push_back({std::unique_ptr<char[]>(new char[size]), size});
+                current = chunks.size() - 1;
+                used = 0;
+                return allocate(bytes, align);
+            }
+
+            /* 函数名称: reset
+             * 功能描述: O(1) 释放之前分配的全部内存（内存本身保留以便复用）。
+             */
+            void reset()
+            {
+                current = 0;
+                used = 0;
+            }
+
+            /* 函数名称: capacity
+             * 功能描述: 返回已向系统申请的总字节数。
+             */
+            auto capacity() const -> size_t
+            {
+                size_t total = 0;
+                for (const auto &c : chunks)
+                    total += c.size;
+                return total;
+            }
+
+        private:
+            struct Chunk
+            {
+                std::unique_ptr<char[]> data; ///< 块内存
+                size_t size;                  ///< 块大小
+            };
+            std::vector<Chunk> chunks; ///< 已申请的所有块
+            size_t current = 0;        ///< 正在使用的块下标
+            size_t used = 0;           ///< 当前块已使用的字节数
+        };
+
+        /* 磁带字的类型标记，存放在每个 64 位字的最高 8 位 */
+        enum class Tag : uint8_t
+        {
+            Null = 'n',
+            True = 't',
+            False = 'f',
+            Int = 'l',    ///< 下一个字是 int64 原始值
+            Float = 'd',  ///< 下一个字是 double 的位模式
+            String = '"', ///< 低 56 位是字符串缓冲区中的偏移
+            ArrayStart = '[',
+            ArrayEnd = ']',
+            ObjectStart = '{',
+            ObjectEnd = '}',
+        };
+
+        constexpr uint64_t payload_mask = (uint64_t{1} << 56) - 1; ///< 低 56 位的有效载荷
+        constexpr uint32_t count_saturated = 0xFFFFFF;               ///< 容器元素计数的饱和值
+
+        class Element;
+
+        /*
+         * 类名: Document
+         * 描述: 一次解析的结果：磁带、字符串缓冲区以及它们所在的 Arena。
+         *       Document 可以重复用于多次解析，每次解析前自动 reset()。
+         */
+        class Document
+        {
+        public:
+            Arena arena;                       ///< 磁带和字符串缓冲区的来源
+            simd::StructuralIndex structurals; ///< 结构索引（跨解析复用其容量）
+            const uint64_t *tape = nullptr;    ///< 磁带起始地址
+            size_t tape_size = 0;              ///< 磁带中的字数
+            const char *strings = nullptr;     ///< 字符串缓冲区：每项为 uint32 长度 + 字节 + '\0'
+
+            /* 函数名称: reset
+             * 功能描述: O(1) 丢弃整棵树，之前返回的 Element 全部失效。
+             */
+            void reset()
+            {
+                arena.reset();
+                tape = nullptr;
+                tape_size = 0;
+                strings = nullptr;
+            }
+
+            inline auto root() const -> Element;
+        };
+
+        /*
+         * 类名: Element
+         * 描述: 指向磁带中某个值的只读视图，仅包含文档指针和磁带下标，可以随意按值传递。
+         */
+        class Element
+        {
+        public:
+            Element(const Document *doc, size_t idx) : doc(doc), idx(idx) {}
+
+            /* 函数名称: tag
+             * 功能描述: 返回当前值的类型标记。
+             */
+            auto tag() const -> Tag { return Tag(doc->tape[idx] >> 56); }
+
+            auto is_null() const -> bool { return tag() == Tag::Null; }
+            auto is_bool() const -> bool { return tag() == Tag::True || tag() == Tag::False; }
+            auto is_int() const -> bool { return tag() == Tag::Int; }
+            auto is_float() const -> bool { return tag() == Tag::Float; }
+            auto is_string() const -> bool { return tag() == Tag::String; }
+            auto is_array() const -> bool { return tag() == Tag::ArrayStart; }
+            auto is_object() const -> bool { return tag() == Tag::ObjectStart; }
+
+            /* 函数名称: as_bool / as_int / as_float / as_string
+             * 功能描述: 读取标量值。
+             * 异常: std::runtime_error 如果类型不匹配（as_float 同时接受整数）。
+             */
+            auto as_bool() const -> Bool
+            {
+                if (!is_bool())
+                    throw std::runtime_error("not a bool");
+                return tag() == Tag::True;
+            }
+
+            auto as_int() const -> Int
+            {
+                if (!is_int())
+                    throw std::runtime_error("not an int");
+                return Int(doc->tape[idx + 1]);
+            }
+
+            auto as_float() const -> Float
+            {
+                if (is_int())
+                    return Float(as_int());
+                if (!is_float())
+                    throw std::runtime_error("not a float");
+                Float f;
+                std::memcpy(&f, &doc->tape[idx + 1], sizeof(f));
+                return f;
+            }
+
+            auto as_string() const -> std::string_view
+            {
+                if (!is_string())
+                    throw std::runtime_error("not a string");
+                return string_at(idx);
+            }
+
+            /* 函数名称: size
+             * 功能描述: 返回数组或对象的元素个数；计数饱和时退化为遍历。
+             * 异常: std::runtime_error 如果当前值不是容器。
+             */
+            auto size() const -> size_t
+            {
+                if (!is_array() && !is_object())
+                    throw std::runtime_error("not a container");
+                size_t count = (doc->tape[idx] >> 32) & count_saturated;
+                if (count < count_saturated)
+                    return count;
+                count = 0;
+                for (auto it = begin(); it != end(); ++it)
+                    ++count;
+                return count;
+            }
+
+            /*
+             * 类名: Iterator
+             * 描述: 遍历数组元素或对象成员；遍历对象时可通过 key() 取得当前键。
+             */
+            class Iterator
+            {
+            public:
+                Iterator(const Document *doc, size_t idx, bool object) : doc(doc), idx(idx), object(object) {}
+                auto operator*() const -> Element { return Element{doc, object ? idx + 1 : idx}; }
+                auto key() const -> std::string_view { return Element{doc, idx}.as_string(); }
+                auto operator++() -> Iterator &
+                {
+                    idx = Element::skip(doc, object ? idx + 1 : idx);
+                    return *this;
+                }
+                auto operator==(const Iterator &rhs) const -> bool { return idx == rhs.idx; }
+                auto operator!=(const Iterator &rhs) const -> bool { return idx != rhs.idx; }
+
+            private:
+                const Document *doc;
+                size_t idx;
+                bool object;
+            };
+
+            auto begin() const -> Iterator { return Iterator{doc, idx + 1, is_object()}; }
+            auto end() const -> Iterator { return Iterator{doc, skip(doc, idx) - 1, is_object()}; }
+
+            /* 函数名称: operator[]
+             * 功能描述: 按键查找对象成员（线性扫描磁带，跳过兄弟节点的整棵子树）。
+             * 异常: std::runtime_error 如果不是对象或键不存在。
+             */
+            auto operator[](std::string_view key) const -> Element
+            {
+                if (!is_object())
+                    throw std::runtime_error("not an object");
+                for (auto it = begin(); it != end(); ++it)
+                {
+                    if (it.key() == key)
+                        return *it;
+                }
+                throw std::runtime_error("key not found");
+            }
+
+            /* 函数名称: operator[]
+             * 功能描述: 按下标访问数组元素。
+             * 异常: std::runtime_error 如果不是数组；std::out_of_range 如果越界。
+             */
+            auto operator[](size_t index) const -> Element
+            {
+                if (!is_array())
+                    throw std::runtime_error("not an array");
+                for (auto it = begin(); it != end(); ++it, --index)
+                {
+                    if (index == 0)
+                        return *it;
+                }
+                throw std::out_of_range("array index out of range");
+            }
+
+            /* 函数名称: to_node
+             * 功能描述: 把视图物化为普通的 Node 树（用于与 JsonGenerator 互通）。
+             */
+            auto to_node() const -> Node
+            {
+                switch (tag())
+                {
+                case Tag::True:
+                case Tag::False:
+                    return Node{as_bool()};
+                case Tag::Int:
+                    return Node{as_int()};
+                case Tag::Float:
+                    return Node{as_float()};
+                case Tag::String:
+                    return Node{String{as_string()}};
+                case Tag::ArrayStart:
+                {
+                    Array arr;
+                    for (auto v : *this)
+                        arr.push_back(v.to_node());
+                    return Node{std::move(arr)};
+                }
+                case Tag::ObjectStart:
+                {
+                    Object obj;
+                    for (auto it = begin(); it != end(); ++it)
+                        obj[std::string{it.key()}] = (*it).to_node();
+                    return Node{std::move(obj)};
+                }
+                default:
+                    return Node{};
+                }
+            }
+
+            /* 函数名称: skip
+             * 功能描述: 返回紧随 idx 处整个值（含子树）之后的磁带下标。容器起始字中保存了这一位置，因此是 O(1)。
+             */
+            static auto skip(const Document *doc, size_t idx) -> size_t
+            {
+                uint64_t word = doc->tape[idx];
+                switch (Tag(word >> 56))
+                {
+                case Tag::ArrayStart:
+                case Tag::ObjectStart:
+                    return uint32_t(word);
+                case Tag::Int:
+                case Tag::Float:
+                    return idx + 2;
+                default:
+                    return idx + 1;
+                }
+            }
+
+        private:
+            auto string_at(size_t i) const -> std::string_view
+            {
+                const char *p = doc->strings + (doc->tape[i] & payload_mask);
+                uint32_t len;
+                std::memcpy(&len, p, sizeof(len));
+                return {p + sizeof(len), len};
+            }
+
+            const Document *doc; ///< 所属文档
+            size_t idx;          ///< 值在磁带中的下标
+        };
+
+        inline auto Document::root() const -> Element { return Element{this, 0}; }
+
+        /*
+         * 结构体: TapeBuilder
+         * 描述: 借助 JsonParser 的结构索引和标量解析函数，把 JSON 文本写成磁带。
+         */
+        struct TapeBuilder
+        {
+            JsonParser p;             ///< 负责位置推进与标量解析
+            uint64_t *tape = nullptr; ///< 磁带（容量由结构索引预先算出）
+            size_t n = 0;             ///< 已写入的字数
+            char *strings = nullptr;  ///< 字符串缓冲区
+            size_t strings_used = 0;  ///< 字符串缓冲区已使用的字节数
+
+            /* 尚未闭合的容器：起始字下标、已有元素个数和结束符 */
+            struct Open
+            {
+                size_t start;
+                uint32_t count;
+                char close;
+            };
+            Open *open = nullptr; ///< 显式栈，代替递归（容量为 min(max_depth, 结构位置数)）
+            size_t depth = 0;     ///< 栈中的容器个数
+
+            void emit(Tag tag, uint64_t payload) { tape[n++] = (uint64_t(tag) << 56) | payload; }
+
+            auto peek() const -> char { return p.pos < p.json_str.size() ? p.json_str[p.pos] : '\0'; }
+
+            /* 函数名称: build_scalar
+             * 功能描述: 与 JsonParser::parse_scalar 相同的分发逻辑，但把结果写入磁带。
+             */
+            auto build_scalar() -> bool
+            {
+                p.parse_whitespace();
+                switch (peek())
+                {
+                case 'n':
+                    return p.parse_null() && (emit(Tag::Null, 0), true);
+                case 't':
+                    return p.parse_true() && (emit(Tag::True, 0), true);
+                case 'f':
+                    return p.parse_false() && (emit(Tag::False, 0), true);
+                case '"':
+                    return build_string();
+                case '\0':
+                    return false;
+                default:
+                {
+                    auto number = p.parse_number();
+                    if (!number)
+                        return false;
+                    if (auto i = std::get_if<Int>(&*number))
+                    {
+                        emit(Tag::Int, 0);
+                        tape[n++] = uint64_t(*i);
+                    }
+                    else
+                    {
+                        emit(Tag::Float, 0);
+                        std::memcpy(&tape[n++], &std::get<Float>(*number), sizeof(Float));
+                    }
+                    return true;
+                }
+                }
+            }
+
+            /* 函数名称: build_string
+             * 功能描述: 经 scan_string 定位字符串，把解码后的内容连同长度前缀写进字符串缓冲区，磁带中只记录偏移。
+             *           解码不会使字符串变长，因此按原始长度预留的缓冲区总是够用。
+             *           含非法转义或未转义的控制字符时失败。
+             */
+            auto build_string() -> bool
+            {
+                bool escaped;
+                auto raw = p.scan_string(escaped);
+                if (!raw)
+                    return false;
+                char *dst = strings + strings_used;
+                uint32_t len = uint32_t(raw->size());
+                if (escaped)
+                {
+                    auto decoded = unescape(*raw, dst + sizeof(len));
+                    if (!decoded)
+                        return false;
+                    len = uint32_t(*decoded);
+                }
+                else
+                {
+                    std::memcpy(dst + sizeof(len), raw->data(), len);
+                }
+                std::memcpy(dst, &len, sizeof(len));
+                dst[sizeof(len) + len] = '\0';
+                emit(Tag::String, strings_used);
+                strings_used += sizeof(len) + len + 1;
+                return true;
+            }
+
+            /* 函数名称: next_element
+             * 功能描述: 栈顶容器即将开始一个新元素；对象需要先写入键并跳过冒号。
+             */
+            auto next_element() -> bool
+            {
+                if (open[depth - 1].close == ']')
+                    return true;
+                p.parse_whitespace();
+                if (peek() != '"' || !build_string())
+                    return false; // 键必须是字符串
+                p.parse_whitespace();
+                if (peek() != ':')
+                    return false;
+                p.pos++;
+                return true;
+            }
+
+            /* 函数名称: close_container
+             * 功能描述: 闭合栈顶容器。起始字在此时回填：低 32 位为结束字之后的下标，
+             *           32~55 位为元素个数（饱和）；结束字记录起始字的下标。
+             */
+            void close_container()
+            {
+                Open top = open[--depth];
+                p.pos++; // 跳过 ] 或 }
+                Tag start_tag = top.close == ']' ? Tag::ArrayStart : Tag::ObjectStart;
+                emit(top.close == ']' ? Tag::ArrayEnd : Tag::ObjectEnd, top.start);
+                tape[top.start] = (uint64_t(start_tag) << 56) | (uint64_t(top.count) << 32) | n;
+            }
+
+            /* 函数名称: build_value
+             * 功能描述: 非递归地把一个完整的值写入磁带。未闭合的容器记在显式栈 open 中，
+             *           嵌套超过 p.max_depth 层时失败并置 p.depth_exceeded。
+             */
+            auto build_value() -> bool
+            {
+                depth = 0;
+                for (;;)
+                {
+                    p.parse_whitespace();
+                    char c = peek();
+                    if (c == '[' || c == '{')
+                    {
+                        if (depth >= p.max_depth)
+                        {
+                            p.depth_exceeded = true;
+                            return false;
+                        }
+                        open[depth++] = {n, 0, c == '[' ? ']' : '}'};
+                        emit(c == '[' ? Tag::ArrayStart : Tag::ObjectStart, 0);
+                        p.pos++; // 跳过 [ 或 {
+                        p.parse_whitespace();
+                        if (peek() != open[depth - 1].close)
+                        {
+                            if (!next_element())
+                                return false;
+                            continue;
+                        }
+                        close_container(); // 空容器
+                    }
+                    else if (!build_scalar())
+                        return false;
+
+                    // 一个值已经完整：计入所在容器，再逐层处理其后的逗号或结束括号
+                    for (;;)
+                    {
+                        if (depth == 0)
+                            return true;
+                        Open &top = open[depth - 1];
+                        top.count += top.count < count_saturated;
+                        p.parse_whitespace();
+                        char d = peek();
+                        if (d == ',')
+                        {
+                            p.pos++;
+                            if (!next_element())
+                                return false;
+                            break;
+                        }
+                        if (d != top.close)
+                            return false;
+                        close_container();
+                    }
+                }
+            }
+        };
+
+        /*
+         * 函数名: parse
+         * 参数: json_str - 要解析的 JSON 文本；doc - 接收结果的文档（会先被 reset）
+         * 返回值: std::optional<Element>，成功时为根元素的视图
+         * 描述: 与 JsonParser::parse_into 一样先校验整个输入是合法的 UTF-8，再构建结构索引，由它得出磁带和
+         *       字符串缓冲区的容量上限，一次性从 Arena 中分配，然后单遍写入。整棵树只产生这两次 Arena 分配
+         *       （外加一块同样由结构索引定出上限的容器栈）。字符串和键在写入时解码转义。根值之后只允许空白。
+         */
+        inline auto parse(std::string_view json_str, Document &doc) -> std::optional<Element>
+        {
+            doc.reset();
+            if (!simd::validate_utf8(json_str) || !doc.structurals.build(json_str))
+                return {};
+            size_t tokens = doc.structurals.positions.size();
+
+            TapeBuilder b{JsonParser{json_str}};
+            b.p.index = doc.structurals.positions.data();
+            b.p.index_size = tokens;
+            // 每个值至少对应一个结构位置，且最多占两个字；每个字符串额外需要 5 字节的长度前缀和结尾 '\0'
+            b.tape = static_cast<uint64_t *>(doc.arena.allocate((2 * tokens + 2) * sizeof(uint64_t)));
+            b.strings = static_cast<char *>(doc.arena.allocate(json_str.size() + 5 * tokens + 8, 1));
+            // 每个未闭合的容器都占一个结构位置，因此栈深不会超过结构位置数
+            b.open = static_cast<TapeBuilder::Open *>(
+                doc.arena.allocate(std::min(tokens, b.p.max_depth) * sizeof(TapeBuilder::Open), alignof(TapeBuilder::Open)));
+            if (!b.build_value() || !b.p.at_end())
+                return {};
+
+            doc.tape = b.tape;
+            doc.tape_size = b.n;
+            doc.strings = b.strings;
+            return doc.root();
+        }
+    }
+
+    /*
+     * 命名空间: borrowed
+     * 描述: 零拷贝解析模式。字符串和键以 std::string_view 的形式直接指向源缓冲区，
+     *       只有含转义序列的字符串才会解码到旁路缓冲区（一个 tape::Arena）中。
+     *       调用方需保证源缓冲区和旁路缓冲区在结果使用期间一直有效。
+     */
+    namespace borrowed
+    {
+        struct Node;
+
+        // 字符串为借用的视图。
+        using String = std::string_view;
+
+        // 数组类型，其中每个元素都是 borrowed::Node。
+        using Array = std::vector<Node>;
+
+        // 对象类型，键同样是借用的视图；与 json::Object 相同的扁平布局，成员按文档顺序存放。
+        using Object = FlatObject<Node, std::hash<std::string_view>, 8, std::string_view>;
+
+        // 与 json::Value 对应，只是字符串、数组和对象换成了借用版本。
+        using Value = std::variant<Null, Bool, Int, Float, String, Array, Object>;
+
+        /**
+         * @brief 借用模式下的节点，只读访问接口与 json::Node 保持一致。
+         */
+        struct Node
+        {
+            Value value; ///< 存储节点值的变体。
+
+            Node(Value _value) : value(std::move(_value)) {}
+            Node() : value(Null{}) {}
+
+            /**
+             * @brief 通过键访问对象类型的值。
+             * @throws std::runtime_error 如果当前Node不是对象类型或键不存在。
+             */
+            auto operator[](std::string_view key) const -> const Node &
+            {
+                if (auto object = std::get_if<Object>(&value))
+                {
+                    auto it = object->find(key);
+                    if (it == object->end())
+                        throw std::runtime_error("key not found");
+                    return it->second;
+                }
+                throw std::runtime_error("not an object");
+            }
+
+            /**
+             * @brief 通过索引访问数组类型的值。
+             * @throws std::runtime_error 如果当前Node不是数组类型。
+             */
+            auto operator[](size_t index) const -> const Node &
+            {
+                if (auto array = std::get_if<Array>(&value))
+                {
+                    return array->at(index);
+                }
+                throw std::runtime_error("not an array");
+            }
+
+            /**
+             * @brief 物化为拥有所有权的 json::Node（字符串在此时才被复制）。
+             */
+            auto to_node() const -> json::Node
+            {
+                return std::visit(
+                    [](auto &&arg) -> json::Node
+                    {
+                        using T = std::decay_t<decltype(arg)>;
+                        if constexpr (std::is_same_v<T, String>)
+                            return json::Node{json::String{arg}};
+                        else if constexpr (std::is_same_v<T, Array>)
+                        {
+                            json::Array arr;
+                            arr.reserve(arg.size());
+                            for (const auto &v : arg)
+                                arr.push_back(v.to_node());
+                            return json::Node{std::move(arr)};
+                        }
+                        else if constexpr (std::is_same_v<T, Object>)
+                        {
+                            json::Object obj;
+                            for (const auto &[k, v] : arg)
+                                obj[std::string{k}] = v.to_node();
+                            return json::Node{std::move(obj)};
+                        }
+                        else
+                            return json::Node{arg};
+                    },
+                    value);
+            }
+        };
+
+        /*
+         * 结构体: BorrowedParser
+         * 描述: 复用 JsonParser 的位置推进与标量解析，字符串只做定位而不复制。
+         */
+        struct BorrowedParser
+        {
+            JsonParser p;      ///< 负责位置推进与标量解析
+            tape::Arena &side; ///< 转义字符串的旁路缓冲区
+
+            auto peek() const -> char { return p.pos < p.json_str.size() ? p.json_str[p.pos] : '\0'; }
+
+            /* 函数名称: parse_string
+             * 功能描述: 无转义的字符串直接返回源缓冲区中的视图；含转义时解码到旁路缓冲区。
+             */
+            auto parse_string() -> std::optional<String>
+            {
+                bool escaped;
+                auto raw = p.scan_string(escaped);
+                if (!raw || !escaped)
+                    return raw;
+                char *out = static_cast<char *>(side.allocate(raw->size(), 1));
+                auto len = unescape(*raw, out);
+                if (!len)
+                    return {};
+                return String{out, *len};
+            }
+
+            /* 函数名称: parse_scalar
+             * 功能描述: 与 JsonParser::parse_scalar 相同的分发逻辑。
+             */
+            auto parse_scalar() -> std::optional<Value>
+            {
+                p.parse_whitespace();
+                switch (peek())
+                {
+                case 'n':
+                    if (!p.parse_null())
+                        return {};
+                    return Value{Null{}};
+                case 't':
+                    if (!p.parse_true())
+                        return {};
+                    return Value{true};
+                case 'f':
+                    if (!p.parse_false())
+                        return {};
+                    return Value{false};
+                case '"':
+                {
+                    auto str = parse_string();
+                    if (!str)
+                        return {};
+                    return Value{*str};
+                }
+                case '\0':
+                    return {};
+                default:
+                {
+                    auto number = p.parse_number();
+                    if (!number)
+                        return {};
+                    if (auto i = std::get_if<Int>(&*number))
+                        return Value{*i};
+                    return Value{std::get<Float>(*number)};
+                }
+                }
+            }
+
+            /* 函数名称: open_slot
+             * 功能描述: 与 JsonParser::open_slot 相同：为容器的下一个元素开辟位置，对象先解析键和冒号。
+             */
+            auto open_slot(Node &container) -> Node *
+            {
+                if (auto array = std::get_if<Array>(&container.value))
+                    return &array->emplace_back();
+                p.parse_whitespace();
+                if (peek() != '"')
+                    return nullptr; // 键必须是字符串
+                auto key = parse_string();
+                if (!key)
+                    return nullptr;
+                p.parse_whitespace();
+                if (peek() != ':')
+                    return nullptr;
+                p.pos++;
+                return &std::get<Object>(container.value).insert_or_assign(*key, Node{}).first->second;
+            }
+
+            /* 函数名称: parse_value
+             * 功能描述: 与 JsonParser::parse_tree 相同的非递归解析，值直接写进它在树中的最终位置。
+             */
+            auto parse_value() -> std::optional<Value>
+            {
+                Node root;
+                std::vector<Node *> open; // 尚未闭合的数组和对象
+                Node *slot = &root;
+                for (;;)
+                {
+                    p.parse_whitespace();
+                    char c = peek();
+                    if (c == '[' || c == '{')
+                    {
+                        if (open.size() >= p.max_depth)
+                        {
+                            p.depth_exceeded = true;
+                            return {};
+                        }
+                        p.pos++; // 跳过 [ 或 {
+                        if (c == '[')
+                            slot->value = Array{};
+                        else
+                            slot->value = Object{};
+                        open.push_back(slot);
+                        p.parse_whitespace();
+                        if (peek() != (c == '[' ? ']' : '}'))
+                        {
+                            if (!(slot = open_slot(*slot)))
+                                return {};
+                            continue;
+                        }
+                        p.pos++; // 空容器
+                        open.pop_back();
+                    }
+                    else
+                    {
+                        auto value = parse_scalar();
+                        if (!value)
+                            return {};
+                        slot->value = std::move(*value);
+                    }
+
+                    // 一个值已经完整：逐层处理其后的逗号或结束括号
+                    for (;;)
+                    {
+                        if (open.empty())
+                            return std::move(root.value);
+                        Node &parent = *open.back();
+                        p.parse_whitespace();
+                        char d = peek();
+                        if (d == ',')
+                        {
+                            p.pos++;
+                            if (!(slot = open_slot(parent)))
+                                return {};
+                            break;
+                        }
+                        if (d != (std::holds_alternative<Array>(parent.value) ? ']' : '}'))
+                            return {};
+                        p.pos++;
+                        open.pop_back();
+                    }
+                }
+            }
+        };
+
+        /*
+         * 函数名: parse
+         * 参数: json_str - 要解析的 JSON 文本（结果中的视图指向它）
+         *       side - 存放转义字符串解码结果的旁路缓冲区
+         * 返回值: std::optional<borrowed::Node>，解析失败时为空
+         * 描述: 零拷贝解析入口，同样先校验 UTF-8、构建结构索引，再在索引位置间跳转。根值之后只允许空白。
+         */
+        inline auto parse(std::string_view json_str, tape::Arena &side) -> std::optional<Node>
+        {
+            if (!simd::validate_utf8(json_str))
+                return {};
+            BorrowedParser b{JsonParser{json_str}, side};
+            simd::StructuralIndex structurals;
+            if (structurals.build(json_str))
+            {
+                b.p.index = structurals.positions.data();
+                b.p.index_size = structurals.positions.size();
+            }
+            auto value = b.parse_value();
+            if (!value || !b.p.at_end())
+                return {};
+            return Node{std::move(*value)};
+        }
+    }
+
+    /*
+     * 命名空间: compact
+     * 描述: 紧凑 DOM。每个值是一个 16 字节的带标签单元（思路来自 union.cpp 中的 var 与 short_str）：
+     *       不超过 14 字节的字符串直接内联在单元中，长字符串、数组和对象只占一个指针大小的句柄。
+     *       访问接口与 json::Node 一致（operator[]、push），经 JsonWriter 输出的文本也与 json::Node 相同。
+     */
+    namespace compact
+    {
+        class Node;
+
+        // 数组类型，元素是 16 字节的 compact::Node。
+        using Array = std::vector<Node>;
+
+        // 对象类型，与 json::Object 使用同一种扁平容器。
+        using Object = FlatObject<Node>;
+
+        /* 值的类型 */
+        enum class Type : uint8_t
+        {
+            Null,
+            Bool,
+            Int,
+            Float,
+            String,
+            Array,
+            Object
+        };
+
+        /*
+         * 类名: Node
+         * 描述: 16 字节的带标签单元。布局为 14 字节载荷 + 1 字节内联长度 + 1 字节标签：
+         *       整数、浮点数和句柄占载荷的前 8 字节，长字符串的长度（uint32）存在其后 4 字节。
+         *       拥有所有权：复制为深复制，移动只搬动 16 字节。
+         */
+        class Node
+        {
+        public:
+            static constexpr size_t inline_capacity = 14; ///< 内联字符串的最大字节数
+
+            Node() noexcept {}
+            Node(Null) noexcept {}
+            Node(Bool v) noexcept : tag(v ? Tag::True : Tag::False) {}
+            Node(Int v) noexcept : tag(Tag::Int) { store(v); }
+            Node(Float v) noexcept : tag(Tag::Float) { store(v); }
+            Node(std::string_view s) { set_string(s); }
+            Node(const char *s) : Node(std::string_view{s}) {}
+            Node(const String &s) : Node(std::string_view{s}) {}
+            Node(Array a) : tag(Tag::Array) { store(new Array(std::move(a))); }
+            Node(Object o) : tag(Tag::Object) { store(new Object(std::move(o))); }
+
+            /* 从 json::Node 转换 */
+            explicit Node(const json::Node &node)
+            {
+                std::visit(
+                    [this](auto &&arg)
+                    {
+                        using T = std::decay_t<decltype(arg)>;
+                        if constexpr (std::is_same_v<T, json::Array>)
+                        {
+                            Array arr;
+                            arr.reserve(arg.size());
+                            for (const auto &v : arg)
+                                arr.emplace_back(v);
+                            *this = Node{std::move(arr)};
+                        }
+                        else if constexpr (std::is_same_v<T, json::Object>)
+                        {
+                            Object obj;
+                            obj.reserve(arg.size());
+                            for (const auto &[k, v] : arg)
+                                obj.insert_or_assign(k, Node{v});
+                            *this = Node{std::move(obj)};
+                        }
+                        else
+                            *this = Node{arg};
+                    },
+                    node.value);
+            }
+
+            Node(const Node &rhs) { copy_from(rhs); }
+            Node(Node &&rhs) noexcept { take(rhs); }
+            auto operator=(const Node &rhs) -> Node &
+            {
+                if (this != &rhs)
+                {
+                    Node tmp(rhs);
+                    release();
+                    take(tmp);
+                }
+                return *this;
+            }
+            auto operator=(Node &&rhs) noexcept -> Node &
+            {
+                if (this != &rhs)
+                {
+                    release();
+                    take(rhs);
+                }
+                return *this;
+            }
+            ~Node() { release(); }
+
+            auto type() const -> Type
+            {
+                switch (tag)
+                {
+                case Tag::Null:
+                    return Type::Null;
+                case Tag::False:
+                case Tag::True:
+                    return Type::Bool;
+                case Tag::Int:
+                    return Type::Int;
+                case Tag::Float:
+                    return Type::Float;
+                case Tag::ShortString:
+                case Tag::LongString:
+                    return Type::String;
+                case Tag::Array:
+                    return Type::Array;
+                default:
+                    return Type::Object;
+                }
+            }
+            auto is_null() const -> bool { return tag == Tag::Null; }
+            auto is_bool() const -> bool { return tag == Tag::True || tag == Tag::False; }
+            auto is_int() const -> bool { return tag == Tag::Int; }
+            auto is_float() const -> bool { return tag == Tag::Float; }
+            auto is_string() const -> bool { return tag == Tag::ShortString || tag == Tag::LongString; }
+            auto is_array() const -> bool { return tag == Tag::Array; }
+            auto is_object() const -> bool { return tag == Tag::Object; }
+
+            auto as_bool() const -> Bool
+            {
+                if (!is_bool())
+                    throw std::runtime_error("not a bool");
+                return tag == Tag::True;
+            }
+            auto as_int() const -> Int
+            {
+                if (!is_int())
+                    throw std::runtime_error("not an integer");
+                return load<Int>();
+            }
+            auto as_float() const -> Float
+            {
+                if (!is_float())
+                    throw std::runtime_error("not a float");
+                return load<Float>();
+            }
+            auto as_string() const -> std::string_view
+            {
+                if (tag == Tag::ShortString)
+                    return {bytes, small_size};
+                if (tag == Tag::LongString)
+                    return {load<const char *>(), load<uint32_t>(8)};
+                throw std::runtime_error("not a string");
+            }
+            auto as_array() -> Array & { return const_cast<Array &>(std::as_const(*this).as_array()); }
+            auto as_array() const -> const Array &
+            {
+                if (!is_array())
+                    throw std::runtime_error("not an array");
+                return *load<Array *>();
+            }
+            auto as_object() -> Object & { return const_cast<Object &>(std::as_const(*this).as_object()); }
+            auto as_object() const -> const Object &
+            {
+                if (!is_object())
+                    throw std::runtime_error("not an object");
+                return *load<Object *>();
+            }
+
+            /**
+             * @brief 通过键访问对象类型的值，键不存在时插入 null（与 json::Node 一致）。
+             * @throws std::runtime_error 如果当前Node不是对象类型。
+             */
+            auto operator[](const std::string &key) -> Node & { return as_object()[key]; }
+
+            /**
+             * @brief 只读访问对象成员。
+             * @throws std::runtime_error 如果当前Node不是对象类型或键不存在。
+             */
+            auto operator[](std::string_view key) const -> const Node &
+            {
+                const auto &object = as_object();
+                auto it = object.find(key);
+                if (it == object.end())
+                    throw std::runtime_error("key not found");
+                return it->second;
+            }
+
+            /**
+             * @brief 通过索引访问数组类型的值。
+             * @throws std::runtime_error 如果当前Node不是数组类型；std::out_of_range 如果越界。
+             */
+            auto operator[](size_t index) -> Node & { return as_array().at(index); }
+            auto operator[](size_t index) const -> const Node & { return as_array().at(index); }
+
+            /**
+             * @brief 向数组类型的Node添加一个新的Node元素，不是数组时忽略（与 json::Node 一致）。
+             */
+            void push(Node rhs)
+            {
+                if (is_array())
+                    load<Array *>()->push_back(std::move(rhs));
+            }
+
+            /* 函数名称: visit
+             * 功能描述: 以 Null / Bool / Int / Float / std::string_view / const Array & / const Object & 之一调用 fn。
+             */
+            template <class F>
+            decltype(auto) visit(F &&fn) const
+            {
+                switch (tag)
+                {
+                case Tag::Null:
+                    return fn(Null{});
+                case Tag::False:
+                case Tag::True:
+                    return fn(Bool(tag == Tag::True));
+                case Tag::Int:
+                    return fn(load<Int>());
+                case Tag::Float:
+                    return fn(load<Float>());
+                case Tag::ShortString:
+                case Tag::LongString:
+                    return fn(as_string());
+                case Tag::Array:
+                    return fn(static_cast<const Array &>(*load<Array *>()));
+                default:
+                    return fn(static_cast<const Object &>(*load<Object *>()));
+                }
+            }
+
+            /* 物化为 json::Node */
+            auto to_node() const -> json::Node
+            {
+                return visit(
+                    [](auto &&arg) -> json::Node
+                    {
+                        using T = std::decay_t<decltype(arg)>;
+                        if constexpr (std::is_same_v<T, std::string_view>)
+                            return json::Node{json::String{arg}};
+                        else if constexpr (std::is_same_v<T, Array>)
+                        {
+                            json::Array arr;
+                            arr.reserve(arg.size());
+                            for (const auto &v : arg)
+                                arr.push_back(v.to_node());
+                            return json::Node{std::move(arr)};
+                        }
+                        else if constexpr (std::is_same_v<T, Object>)
+                        {
+                            json::Object obj;
+                            obj.reserve(arg.size());
+                            for (const auto &[k, v] : arg)
+                                obj.insert_or_assign(k, v.to_node());
+                            return json::Node{std::move(obj)};
+                        }
+                        else
+                            return json::Node{arg};
+                    });
+            }
+
+        private:
+            enum class Tag : uint8_t
+            {
+                Null,
+                False,
+                True,
+                Int,
+                Float,
+                ShortString,
+                LongString,
+                Array,
+                Object
+            };
+
+            alignas(8) char bytes[inline_capacity] = {}; ///< 载荷
+            uint8_t small_size = 0;                      ///< 内联字符串的长度
+            Tag tag = Tag::Null;                         ///< 类型标签
+
+            template <class T>
+            void store(T v, size_t at = 0) { std::memcpy(bytes + at, &v, sizeof(T)); }
+            template <class T>
+            auto load(size_t at = 0) const -> T
+            {
+                T v;
+                std::memcpy(&v, bytes + at, sizeof(T));
+                return v;
+            }
+
+            void set_string(std::string_view s)
+            {
+                if (s.size() <= inline_capacity)
+                {
+                    tag = Tag::ShortString;
+                    std::memcpy(bytes, s.data(), s.size());
+                    small_size = uint8_t(s.size());
+                    return;
+                }
+                if (s.size() > UINT32_MAX)
+                    throw std::length_error("string too long");
+                char *p = new char[s.size()];
+                std::memcpy(p, s.data(), s.size());
+                store(p);
+                store(uint32_t(s.size()), 8);
+                tag = Tag::LongString;
+            }
+
+            void release() noexcept
+            {
+                switch (tag)
+                {
+                case Tag::LongString:
+                    delete[] load<char *>();
+                    break;
+                case Tag::Array:
+                    delete load<Array *>();
+                    break;
+                case Tag::Object:
+                    delete load<Object *>();
+                    break;
+                default:
+                    break;
+                }
+                tag = Tag::Null;
+            }
+
+            void copy_from(const Node &rhs)
+            {
+                switch (rhs.tag)
+                {
+                case Tag::LongString:
+                    set_string(rhs.as_string());
+                    break;
+                case Tag::Array:
+                    store(new Array(*rhs.load<Array *>()));
+                    tag = Tag::Array;
+                    break;
+                case Tag::Object:
+                    store(new Object(*rhs.load<Object *>()));
+                    tag = Tag::Object;
+                    break;
+                default:
+                    std::memcpy(bytes, rhs.bytes, sizeof(bytes));
+                    small_size = rhs.small_size;
+                    tag = rhs.tag;
+                    break;
+                }
+            }
+
+            /* 接管 rhs 的 16 字节，rhs 变为 null */
+            void take(Node &rhs) noexcept
+            {
+                std::memcpy(bytes, rhs.bytes, sizeof(bytes));
+                small_size = rhs.small_size;
+                tag = rhs.tag;
+                rhs.tag = Tag::Null;
+            }
+        };
+
+        static_assert(sizeof(Node) == 16, "compact::Node must stay a 16-byte cell");
+
+        /*
+         * 结构体: CompactParser
+         * 描述: 与 BorrowedParser 相同的结构：复用 JsonParser 的位置推进与标量解析，直接构建 compact::Node。
+         *       字符串在此解码转义；设置了 p.keys 时对象键被驻留。
+         */
+        struct CompactParser
+        {
+            JsonParser p;            ///< 负责位置推进与标量解析
+            std::string scratch{};   ///< 转义字符串的解码缓冲区
+
+            auto peek() const -> char { return p.pos < p.json_str.size() ? p.json_str[p.pos] : '\0'; }
+
+            auto parse_string() -> std::optional<std::string_view>
+            {
+                bool escaped;
+                auto raw = p.scan_string(escaped);
+                if (!raw || !escaped)
+                    return raw;
+                scratch.resize(raw->size());
+                auto len = unescape(*raw, scratch.data());
+                if (!len)
+                    return {};
+                return std::string_view{scratch.data(), *len};
+            }
+
+            /* 函数名称: parse_scalar
+             * 功能描述: 与 JsonParser::parse_scalar 相同的分发逻辑。
+             */
+            auto parse_scalar() -> std::optional<Node>
+            {
+                p.parse_whitespace();
+                switch (peek())
+                {
+                case 'n':
+                    if (!p.parse_null())
+                        return {};
+                    return Node{};
+                case 't':
+                    if (!p.parse_true())
+                        return {};
+                    return Node{true};
+                case 'f':
+                    if (!p.parse_false())
+                        return {};
+                    return Node{false};
+                case '"':
+                {
+                    auto str = parse_string();
+                    if (!str)
+                        return {};
+                    return Node{*str};
+                }
+                case '\0':
+                    return {};
+                default:
+                {
+                    auto number = p.parse_number();
+                    if (!number)
+                        return {};
+                    if (auto i = std::get_if<Int>(&*number))
+                        return Node{*i};
+                    return Node{std::get<Float>(*number)};
+                }
+                }
+            }
+
+            /* 函数名称: open_slot
+             * 功能描述: 与 JsonParser::open_slot 相同：为容器的下一个元素开辟位置，对象先解析键和冒号。
+             */
+            auto open_slot(Node &container) -> Node *
+            {
+                if (container.is_array())
+                    return &container.as_array().emplace_back();
+                p.parse_whitespace();
+                if (peek() != '"')
+                    return nullptr; // 键必须是字符串
+                auto raw = parse_string();
+                if (!raw)
+                    return nullptr;
+                Key key = p.keys ? Key{p.keys->intern(*raw)} : Key{std::string(*raw)};
+                p.parse_whitespace();
+                if (peek() != ':')
+                    return nullptr;
+                p.pos++;
+                return &container.as_object().insert_or_assign(std::move(key), Node{}).first->second;
+            }
+
+            /* 函数名称: parse_value
+             * 功能描述: 与 JsonParser::parse_tree 相同的非递归解析，值直接写进它在树中的最终位置。
+             */
+            auto parse_value() -> std::optional<Node>
+            {
+                Node root;
+                std::vector<Node *> open; // 尚未闭合的数组和对象
+                Node *slot = &root;
+                for (;;)
+                {
+                    p.parse_whitespace();
+                    char c = peek();
+                    if (c == '[' || c == '{')
+                    {
+                        if (open.size() >= p.max_depth)
+                        {
+                            p.depth_exceeded = true;
+                            return {};
+                        }
+                        p.pos++; // 跳过 [ 或 {
+                        if (c == '[')
+                            *slot = Node{Array{}};
+                        else
+                            *slot = Node{Object{}};
+                        open.push_back(slot);
+                        p.parse_whitespace();
+                        if (peek() != (c == '[' ? ']' : '}'))
+                        {
+                            if (!(slot = open_slot(*slot)))
+                                return {};
+                            continue;
+                        }
+                        p.pos++; // 空容器
+                        open.pop_back();
+                    }
+                    else
+                    {
+                        auto value = parse_scalar();
+                        if (!value)
+                            return {};
+                        *slot = std::move(*value);
+                    }
+
+                    // 一个值已经完整：逐层处理其后的逗号或结束括号
+                    for (;;)
+                    {
+                        if (open.empty())
+                            return root;
+                        Node &parent = *open.back();
+                        p.parse_whitespace();
+                        char d = peek();
+                        if (d == ',')
+                        {
+                            p.pos++;
+                            if (!(slot = open_slot(parent)))
+                                return {};
+                            break;
+                        }
+                        if (d != (parent.is_array() ? ']' : '}'))
+                            return {};
+                        p.pos++;
+                        open.pop_back();
+                    }
+                }
+            }
+        };
+
+        /*
+         * 函数名: parse
+         * 参数: json_str - 要解析的 JSON 文本
+         *       structurals - 结构索引的存储，跨多次调用复用可以避免重复分配
+         *       keys - 可选的键池
+         * 返回值: std::optional<compact::Node>，解析失败（包括根值之后还有非空白内容）时为空
+         */
+        inline auto parse(std::string_view json_str, simd::StructuralIndex &structurals, KeyPool *keys = nullptr)
+            -> std::optional<Node>
+        {
+            if (!simd::validate_utf8(json_str))
+                return {};
+            CompactParser c{JsonParser{json_str}};
+            c.p.keys = keys;
+            if (structurals.build(json_str))
+            {
+                c.p.index = structurals.positions.data();
+                c.p.index_size = structurals.positions.size();
+            }
+            auto root = c.parse_value();
+            if (!root || !c.p.at_end())
+                return {};
+            return root;
+        }
+
+        inline auto parse(std::string_view json_str) -> std::optional<Node>
+        {
+            simd::StructuralIndex structurals;
+            return parse(json_str, structurals);
+        }
+    }
+
+    /*
+     * 命名空间: persistent
+     * 描述: 不可变、结构共享的 DOM，适合一个写者、许多读者共享的配置树。数组、对象和字符串放在引用计数的
+     *       不可变存储中，复制 Node 只增加一次引用计数；修改通过路径复制完成：set / push / erase 返回新的 Node，
+     *       只为从根到修改处路径上的容器分配新存储，其余子树与旧版本共享。Store 用原子指针发布当前根，
+     *       读者无等待地取得一致的快照。
+     */
+    namespace persistent
+    {
+        class Node;
+
+        // 数组类型，构造完成后不再修改。
+        using Array = std::vector<Node>;
+
+        // 对象类型，构造完成后不再修改。用键池解析的键在路径复制时只复制句柄。
+        using Object = FlatObject<Node>;
+
+        /*
+         * 类名: Node
+         * 描述: 不可变的 JSON 值。标量直接存放，字符串、数组和对象通过 shared_ptr<const T> 共享，
+         *       因此复制是 O(1) 的，多个线程可以同时读取同一个 Node 及其任意副本。
+         */
+        class Node
+        {
+        public:
+            Node() noexcept {}
+            Node(Null) noexcept {}
+            Node(Bool v) noexcept : data(v) {}
+            Node(Int v) noexcept : data(v) {}
+            Node(int v) noexcept : data(Int(v)) {} // 使 x["version"] = 114514 不产生二义性
+            Node(Float v) noexcept : data(v) {}
+            Node(std::string_view s) : data(std::make_shared<const String>(s)) {}
+            Node(const char *s) : Node(std::string_view{s}) {}
+            Node(String s) : data(std::make_shared<const String>(std::move(s))) {}
+            Node(Array a) : data(std::make_shared<const Array>(std::move(a))) {}
+            Node(Object o) : data(std::make_shared<const Object>(std::move(o))) {}
+
+            /* 从 json::Node 转换（深复制一次，之后的修改都是路径复制） */
+            explicit Node(const json::Node &node)
+            {
+                std::visit(
+                    [this](auto &&arg)
+                    {
+                        using T = std::decay_t<decltype(arg)>;
+                        if constexpr (std::is_same_v<T, json::Array>)
+                        {
+                            Array arr;
+                            arr.reserve(arg.size());
+                            for (const auto &v : arg)
+                                arr.emplace_back(v);
+                            *this = Node{std::move(arr)};
+                        }
+                        else if constexpr (std::is_same_v<T, json::Object>)
+                        {
+                            Object obj;
+                            obj.reserve(arg.size());
+                            for (const auto &[k, v] : arg)
+                                obj.insert_or_assign(k, Node{v});
+                            *this = Node{std::move(obj)};
+                        }
+                        else
+                            *this = Node{arg};
+                    },
+                    node.value);
+            }
+
+            auto is_null() const -> bool { return std::holds_alternative<Null>(data); }
+            auto is_bool() const -> bool { return std::holds_alternative<Bool>(data); }
+            auto is_int() const -> bool { return std::holds_alternative<Int>(data); }
+            auto is_float() const -> bool { return std::holds_alternative<Float>(data); }
+            auto is_string() const -> bool { return std::holds_alternative<StringPtr>(data); }
+            auto is_array() const -> bool { return std::holds_alternative<ArrayPtr>(data); }
+            auto is_object() const -> bool { return std::holds_alternative<ObjectPtr>(data); }
+
+            auto as_bool() const -> Bool
+            {
+                if (!is_bool())
+                    throw std::runtime_error("not a bool");
+                return std::get<Bool>(data);
+            }
+            auto as_int() const -> Int
+            {
+                if (!is_int())
+                    throw std::runtime_error("not an integer");
+                return std::get<Int>(data);
+            }
+            auto as_float() const -> Float
+            {
+                if (!is_float())
+                    throw std::runtime_error("not a float");
+                return std::get<Float>(data);
+            }
+            auto as_string() const -> std::string_view
+            {
+                if (!is_string())
+                    throw std::runtime_error("not a string");
+                return *std::get<StringPtr>(data);
+            }
+            auto as_array() const -> const Array &
+            {
+                if (!is_array())
+                    throw std::runtime_error("not an array");
+                return *std::get<ArrayPtr>(data);
+            }
+            auto as_object() const -> const Object &
+            {
+                if (!is_object())
+                    throw std::runtime_error("not an object");
+                return *std::get<ObjectPtr>(data);
+            }
+
+            /**
+             * @brief 只读访问对象成员。
+             * @throws std::runtime_error 如果当前Node不是对象类型或键不存在。
+             */
+            auto operator[](std::string_view key) const -> const Node &
+            {
+                const auto &object = as_object();
+                auto it = object.find(key);
+                if (it == object.end())
+                    throw std::runtime_error("key not found");
+                return it->second;
+            }
+
+            /**
+             * @brief 通过索引访问数组类型的值。
+             * @throws std::runtime_error 如果当前Node不是数组类型；std::out_of_range 如果越界。
+             */
+            auto operator[](size_t index) const -> const Node & { return as_array().at(index); }
+
+            /**
+             * @brief 返回把成员 key 设为 value（不存在时追加）后的新对象，当前节点不变。
+             *        新对象的其余成员与当前对象共享。
+             * @throws std::runtime_error 如果当前Node不是对象类型。
+             */
+            auto set(std::string_view key, Node value) const -> Node
+            {
+                Object copy = as_object(); // 成员只增加引用计数
+                auto it = copy.find(key);
+                if (it != copy.end())
+                    it->second = std::move(value);
+                else
+                    copy.insert_or_assign(String{key}, std::move(value));
+                return Node{std::move(copy)};
+            }
+
+            /**
+             * @brief 返回把第 index 个元素替换为 value 后的新数组，当前节点不变。
+             * @throws std::runtime_error 如果当前Node不是数组类型；std::out_of_range 如果越界。
+             */
+            auto set(size_t index, Node value) const -> Node
+            {
+                Array copy = as_array();
+                copy.at(index) = std::move(value);
+                return Node{std::move(copy)};
+            }
+
+            /**
+             * @brief 返回在末尾追加 value 后的新数组，当前节点不变。
+             * @throws std::runtime_error 如果当前Node不是数组类型。
+             */
+            auto push(Node value) const -> Node
+            {
+                const auto &array = as_array();
+                Array copy;
+                copy.reserve(array.size() + 1);
+                copy.insert(copy.end(), array.begin(), array.end());
+                copy.push_back(std::move(value));
+                return Node{std::move(copy)};
+            }
+
+            /**
+             * @brief 返回删除成员 key 后的新对象（键不存在时返回当前节点的副本），当前节点不变。
+             * @throws std::runtime_error 如果当前Node不是对象类型。
+             */
+            auto erase(std::string_view key) const -> Node
+            {
+                if (!as_object().contains(key))
+                    return *this;
+                Object copy = as_object();
+                copy.erase(key);
+                return Node{std::move(copy)};
+            }
+
+            /* 两个节点是否共享同一份字符串 / 容器存储（用来确认路径复制之外的子树没有被复制） */
+            auto shares(const Node &other) const -> bool
+            {
+                return data.index() == other.data.index() && storage() && storage() == other.storage();
+            }
+
+            /* 函数名称: visit
+             * 功能描述: 以 Null / Bool / Int / Float / std::string_view / const Array & / const Object & 之一调用 fn。
+             */
+            template <class F>
+            decltype(auto) visit(F &&fn) const
+            {
+                switch (data.index())
+                {
+                case 0:
+                    return fn(Null{});
+                case 1:
+                    return fn(std::get<Bool>(data));
+                case 2:
+                    return fn(std::get<Int>(data));
+                case 3:
+                    return fn(std::get<Float>(data));
+                case 4:
+                    return fn(std::string_view{*std::get<StringPtr>(data)});
+                case 5:
+                    return fn(*std::get<ArrayPtr>(data));
+                default:
+                    return fn(*std::get<ObjectPtr>(data));
+                }
+            }
+
+            /* 物化为 json::Node */
+            auto to_node() const -> json::Node
+            {
+                return visit(
+                    [](auto &&arg) -> json::Node
+                    {
+                        using T = std::decay_t<decltype(arg)>;
+                        if constexpr (std::is_same_v<T, std::string_view>)
+                            return json::Node{json::String{arg}};
+                        else if constexpr (std::is_same_v<T, Array>)
+                        {
+                            json::Array arr;
+                            arr.reserve(arg.size());
+                            for (const auto &v : arg)
+                                arr.push_back(v.to_node());
+                            return json::Node{std::move(arr)};
+                        }
+                        else if constexpr (std::is_same_v<T, Object>)
+                        {
+                            json::Object obj;
+                            obj.reserve(arg.size());
+                            for (const auto &[k, v] : arg)
+                                obj.insert_or_assign(k, v.to_node());
+                            return json::Node{std::move(obj)};
+                        }
+                        else
+                            return json::Node{arg};
+                    });
+            }
+
+        private:
+            using StringPtr = std::shared_ptr<const String>;
+            using ArrayPtr = std::shared_ptr<const Array>;
+            using ObjectPtr = std::shared_ptr<const Object>;
+
+            std::variant<Null, Bool, Int, Float, StringPtr, ArrayPtr, ObjectPtr> data;
+
+            auto storage() const -> const void *
+            {
+                switch (data.index())
+                {
+                case 4:
+                    return std::get<StringPtr>(data).get();
+                case 5:
+                    return std::get<ArrayPtr>(data).get();
+                case 6:
+                    return std::get<ObjectPtr>(data).get();
+                default:
+                    return nullptr;
+                }
+            }
+        };
+
+        /*
+         * 类名: Editor
+         * 描述: 以赋值语法做路径复制：editor["a"]["b"] = 1 等价于
+         *       root = root.set("a", root["a"].set("b", 1))，旧的根不受影响。
+         *       operator[] 返回的 Ref 引用所在表达式中的临时对象，只能在同一个表达式内使用。
+         */
+        class Editor
+        {
+        public:
+            class Ref
+            {
+            public:
+                auto operator[](std::string_view key) const -> Ref { return Ref{editor, this, key, 0, true}; }
+                auto operator[](size_t index) const -> Ref { return Ref{editor, this, {}, index, false}; }
+
+                /* 当前值
+                 * 异常: std::runtime_error 如果路径上的键不存在或类型不符；std::out_of_range 如果越界
+                 */
+                auto get() const -> const Node &
+                {
+                    const Node &parent_node = parent ? parent->get() : editor->tree;
+                    return by_key ? parent_node[key] : parent_node[index];
+                }
+                operator const Node &() const { return get(); }
+
+                /* 写入新值：逐层复制父容器直到根。对象中不存在的键会被追加 */
+                auto operator=(Node value) -> Ref &
+                {
+                    assign(std::move(value));
+                    return *this;
+                }
+                auto operator=(const Ref &rhs) -> Ref & { return *this = Node{rhs.get()}; }
+
+            private:
+                friend class Editor;
+
+                Editor *editor;
+                const Ref *parent; ///< 为 nullptr 时父节点是根
+                std::string_view key;
+                size_t index;
+                bool by_key;
+
+                Ref(Editor *editor, const Ref *parent, std::string_view key, size_t index, bool by_key)
+                    : editor(editor), parent(parent), key(key), index(index), by_key(by_key) {}
+                Ref(const Ref &) = default;
+
+                void assign(Node value) const
+                {
+                    const Node &parent_node = parent ? parent->get() : editor->tree;
+                    Node next = by_key ? parent_node.set(key, std::move(value)) : parent_node.set(index, std::move(value));
+                    if (parent)
+                        parent->assign(std::move(next));
+                    else
+                        editor->tree = std::move(next);
+                }
+            };
+
+            explicit Editor(Node root) : tree(std::move(root)) {}
+
+            auto operator[](std::string_view key) -> Ref { return Ref{this, nullptr, key, 0, true}; }
+            auto operator[](size_t index) -> Ref { return Ref{this, nullptr, {}, index, false}; }
+
+            /* 编辑后的根 */
+            auto root() const -> const Node & { return tree; }
+            void set_root(Node root) { tree = std::move(root); }
+
+        private:
+            Node tree;
+        };
+
+        /*
+         * 类名: Store
+         * 描述: 通过原子指针发布当前根。读者（load / read）只做一次原子读取、两次计数器的原子加减和一次
+         *       引用计数递增，不加锁也不循环等待，总能在有限步内拿到某一时刻完整的根；写者（store / update）
+         *       之间用互斥锁串行，发布新根后等待宽限期结束再释放旧根。
+         *
+         *       宽限期用两组读者计数器实现：读者进入时按当前纪元的奇偶登记到其中一组。写者交换根之后翻转纪元
+         *       并等待旧的一组归零，再翻转一次等待另一组归零（与 userspace RCU 相同），之后不可能再有读者持有旧根的
+         *       裸指针。读者在 read 的回调中停留多久，写者就可能等多久，回调应当简短。
+         */
+        class Store
+        {
+        public:
+            explicit Store(Node root = {}) : current(new Node(std::move(root))) {}
+            ~Store() { delete current.load(); }
+            Store(const Store &) = delete;
+            Store &operator=(const Store &) = delete;
+
+            /* 无等待地取得当前根的快照，之后的读取不需要任何同步 */
+            auto load() const -> Node
+            {
+                return read([](const Node &root)
+                            { return root; });
+            }
+
+            /* 函数名称: read
+             * 功能描述: 在读侧临界区内以当前根调用 fn，不复制根（也就不触碰引用计数）。
+             *           fn 的返回值不能引用树中的节点，需要长期持有时请用 load()。
+             */
+            template <class F>
+            auto read(F &&fn) const -> std::invoke_result_t<F, const Node &>
+            {
+                Reader guard(*this);
+                return fn(*current.load());
+            }
+
+            /* 发布一个新的根 */
+            void store(Node root)
+            {
+                std::lock_guard lock(writer);
+                publish(new Node(std::move(root)));
+            }
+
+            /* 函数名称: update
+             * 功能描述: 在当前根上调用 fn(Editor &)，再发布编辑后的根；写者之间串行，不会丢失更新。
+             * 返回值: 新发布的根
+             */
+            template <class F>
+            auto update(F &&fn) -> Node
+            {
+                std::lock_guard lock(writer);
+                Editor editor{*current.load()}; // 持有写锁时当前根不会被释放
+                fn(editor);
+                publish(new Node(editor.root()));
+                return editor.root();
+            }
+
+        private:
+            /* 独占一个缓存行，避免读者之间的伪共享 */
+            struct alignas(64) Counter
+            {
+                std::atomic<size_t> readers{0};
+            };
+
+            /* 读侧临界区 */
+            class Reader
+            {
+            public:
+                explicit Reader(const Store &store)
+                    : counter(store.counters[store.epoch.load() & 1].readers)
+                {
+                    counter.fetch_add(1);
+                }
+                ~Reader() { counter.fetch_sub(1); }
+
+            private:
+                std::atomic<size_t> &counter;
+            };
+
+            std::atomic<const Node *> current;
+            std::atomic<size_t> epoch{0};
+            mutable Counter counters[2];
+            std::mutex writer;
+
+            /* 交换根，等待两轮宽限期后释放旧根；调用方持有写锁 */
+            void publish(const Node *next)
+            {
+                const Node *old = current.exchange(next);
+                for (int flip = 0; flip < 2; flip++)
+                {
+                    size_t retired = epoch.fetch_add(1) & 1; // 之后进入的读者登记到另一组
+                    while (counters[retired].readers.load() != 0)
+                        std::this_thread::yield();
+                }
+                delete old; // 只释放根本身，与新根共享的子树由引用计数保留
+            }
+        };
+    }
+
+    /*
+     * 命名空间: sax
+     * 描述: 事件流式解析接口。解析器每识别出一个记号就回调处理器，不构建任何 Node；
+     *       处理器的任一回调返回 false 即可提前终止解析。
+     */
+    namespace sax
+    {
+        /*
+         * 结构体: Handler
+         * 描述: 所有回调均为空操作的处理器基类，使用者只需覆盖（隐藏）关心的回调。
+         *       回调通过模板静态分发，因此不需要 virtual。
+         */
+        struct Handler
+        {
+            auto on_null() -> bool { return true; }
+            auto on_bool(Bool) -> bool { return true; }
+            auto on_int(Int) -> bool { return true; }
+            auto on_double(Float) -> bool { return true; }
+            auto on_string(std::string_view) -> bool { return true; }
+            auto on_key(std::string_view) -> bool { return true; }
+            auto start_object() -> bool { return true; }
+            auto end_object() -> bool { return true; }
+            auto start_array() -> bool { return true; }
+            auto end_array() -> bool { return true; }
+        };
+
+        /* 解析结果 */
+        enum class Status
+        {
+            Done,    ///< 完整解析了一个值
+            Aborted, ///< 处理器要求提前终止
+            Error,   ///< 输入格式错误
+        };
+
+        /*
+         * 结构体: Parser
+         * 描述: 复用 JsonParser 的位置推进与标量解析，与 parse_value 相同的分发逻辑，
+         *       只是把结果以事件的形式交给处理器。字符串以视图形式回调，
+         *       含转义的字符串解码到一个复用的暂存缓冲区中，因此视图只在回调期间有效。
+         */
+        template <class H>
+        struct Parser
+        {
+            JsonParser p;          ///< 负责位置推进与标量解析
+            H &handler;            ///< 事件处理器
+            std::string scratch{}; ///< 转义字符串的暂存缓冲区
+            bool aborted = false;  ///< 处理器是否要求终止
+            std::string open{};    ///< 尚未闭合容器的结束符，充当显式栈（不超过 15 层时不分配）
+
+            auto peek() const -> char { return p.pos < p.json_str.size() ? p.json_str[p.pos] : '\0'; }
+
+            /* 函数名称: emit
+             * 功能描述: 记录回调的返回值，返回 false 表示应当停止。
+             */
+            auto emit(bool keep_going) -> bool
+            {
+                aborted = aborted || !keep_going;
+                return keep_going;
+            }
+
+            /* 函数名称: parse_string
+             * 功能描述: 定位字符串并在必要时解码转义，返回内容视图。
+             */
+            auto parse_string() -> std::optional<std::string_view>
+            {
+                bool escaped;
+                auto raw = p.scan_string(escaped);
+                if (!raw || !escaped)
+                    return raw;
+                scratch.resize(raw->size());
+                auto len = unescape(*raw, scratch.data());
+                if (!len)
+                    return {};
+                return std::string_view{scratch.data(), *len};
+            }
+
+            /* 函数名称: parse_scalar
+             * 功能描述: 根据当前字符解析一个非容器的值并发出相应的事件。
+             * 返回值: bool（出错或被终止时返回 false）
+             */
+            auto parse_scalar() -> bool
+            {
+                switch (peek())
+                {
+                case 'n':
+                    return p.parse_null() && emit(handler.on_null());
+                case 't':
+                    return p.parse_true() && emit(handler.on_bool(true));
+                case 'f':
+                    return p.parse_false() && emit(handler.on_bool(false));
+                case '"':
+                {
+                    auto str = parse_string();
+                    return str && emit(handler.on_string(*str));
+                }
+                case '\0':
+                    return false;
+                default:
+                {
+                    auto number = p.parse_number();
+                    if (!number)
+                        return false;
+                    if (auto i = std::get_if<Int>(&*number))
+                        return emit(handler.on_int(*i));
+                    return emit(handler.on_double(std::get<Float>(*number)));
+                }
+                }
+            }
+
+            /* 函数名称: next_element
+             * 功能描述: 栈顶容器即将开始一个新元素；对象需要先解析键（发出 on_key）和冒号。
+             */
+            auto next_element() -> bool
+            {
+                if (open.back() == ']')
+                    return true;
+                p.parse_whitespace();
+                if (peek() != '"')
+                    return false; // 键必须是字符串
+                auto key = parse_string();
+                if (!key || !emit(handler.on_key(*key)))
+                    return false;
+                p.parse_whitespace();
+                if (peek() != ':')
+                    return false;
+                p.pos++;
+                return true;
+            }
+
+            /* 函数名称: close
+             * 功能描述: 跳过栈顶容器的结束括号并发出 end_array/end_object。
+             */
+            auto close() -> bool
+            {
+                char c = open.back();
+                p.pos++;
+                open.pop_back();
+                return emit(c == ']' ? handler.end_array() : handler.end_object());
+            }
+
+            /* 函数名称: parse_value
+             * 功能描述: 非递归地解析一个完整的值并发出事件。未闭合的容器只以结束符的形式记在 open 中（每层 1 字节），
+             *           调用栈深度与输入的嵌套深度无关；嵌套超过 p.max_depth 层时失败并置 p.depth_exceeded。
+             * 返回值: bool（出错、过深或被终止时返回 false）
+             */
+            auto parse_value() -> bool
+            {
+                open.clear();
+                for (;;)
+                {
+                    p.parse_whitespace();
+                    char c = peek();
+                    if (c == '[' || c == '{')
+                    {
+                        if (open.size() >= p.max_depth)
+                        {
+                            p.depth_exceeded = true;
+                            return false;
+                        }
+                        p.pos++;
+                        open.push_back(c == '[' ? ']' : '}');
+                        if (!emit(c == '[' ? handler.start_array() : handler.start_object()))
+                            return false;
+                        p.parse_whitespace();
+                        if (peek() != open.back())
+                        {
+                            if (!next_element())
+                                return false;
+                            continue;
+                        }
+                        if (!close()) // 空容器
+                            return false;
+                    }
+                    else if (!parse_scalar())
+                        return false;
+
+                    // 一个值已经完整：逐层处理其后的逗号或结束括号
+                    for (;;)
+                    {
+                        if (open.empty())
+                            return true;
+                        p.parse_whitespace();
+                        char d = peek();
+                        if (d == ',')
+                        {
+                            p.pos++;
+                            if (!next_element())
+                                return false;
+                            break;
+                        }
+                        if (d != open.back() || !close())
+                            return false;
+                    }
+                }
+            }
+        };
+
+        /*
+         * 函数名: parse
+         * 参数: json_str - 要解析的 JSON 文本
+         *       handler - 事件处理器
+         *       max_depth - 允许的最大嵌套层数，超过时按格式错误处理
+         * 返回值: Status，区分正常完成、被处理器终止和格式错误
+         * 描述: 事件解析入口。为了让内存占用与文档大小无关，这里不构建结构索引，直接逐字节扫描。
+         *       开始回调之前先校验整个输入是合法的 UTF-8，非法输入不产生任何事件。
+         *       根值之后还有非空白内容时返回 Error（根值的事件此时已经全部发出）。
+         */
+        template <class H>
+        auto parse(std::string_view json_str, H &handler, size_t max_depth = default_max_depth) -> Status
+        {
+            if (!simd::validate_utf8(json_str))
+                return Status::Error;
+            Parser<H> sp{JsonParser{json_str}, handler};
+            sp.p.max_depth = max_depth;
+            if (sp.parse_value())
+                return sp.p.at_end() ? Status::Done : Status::Error;
+            return sp.aborted ? Status::Aborted : Status::Error;
+        }
+
+        /*
+         * 结构体: DomBuilder
+         * 描述: 把事件流还原成 Node 树的处理器，用显式栈保存未闭合的容器。
+         *       每当一个顶层值完整闭合，就把它交给 on_document；on_document 返回 false 时终止解析。
+         */
+        struct DomBuilder : Handler
+        {
+            std::function<bool(Node &&)> on_document; ///< 顶层值完成时的回调
+            std::vector<Node> stack;                  ///< 尚未闭合的数组和对象
+            std::vector<std::string> keys;            ///< 各层对象中等待取值的键
+
+            explicit DomBuilder(std::function<bool(Node &&)> on_document) : on_document(std::move(on_document)) {}
+
+            /* 函数名称: add
+             * 功能描述: 把一个完整的值挂到当前容器上；栈为空时它就是一个顶层值。
+             */
+            auto add(Node &&value) -> bool
+            {
+                if (stack.empty())
+                    return on_document(std::move(value));
+                if (auto array = std::get_if<Array>(&stack.back().value))
+                {
+                    array->push_back(std::move(value));
+                    return true;
+                }
+                std::get<Object>(stack.back().value)[std::move(keys.back())] = std::move(value);
+                keys.pop_back();
+                return true;
+            }
+
+            auto on_null() -> bool { return add(Node{}); }
+            auto on_bool(Bool v) -> bool { return add(Node{v}); }
+            auto on_int(Int v) -> bool { return add(Node{v}); }
+            auto on_double(Float v) -> bool { return add(Node{v}); }
+            auto on_string(std::string_view v) -> bool { return add(Node{String{v}}); }
+            auto on_key(std::string_view key) -> bool
+            {
+                keys.emplace_back(key);
+                return true;
+            }
+            auto start_object() -> bool
+            {
+                stack.emplace_back(Object{});
+                return true;
+            }
+            auto start_array() -> bool
+            {
+                stack.emplace_back(Array{});
+                return true;
+            }
+            auto end_object() -> bool { return close(); }
+            auto end_array() -> bool { return close(); }
+
+        private:
+            auto close() -> bool
+            {
+                Node value = std::move(stack.back());
+                stack.pop_back();
+                return add(std::move(value));
+            }
+        };
+    }
+
+    /*
+     * 命名空间: push
+     * 描述: 可恢复的推送式解析器。数据可以分块通过 feed() 送入，解析状态全部保存在显式栈和状态字段中，
+     *       因此块边界可以落在任意位置（包括字符串或数字的中间）。每识别出一个记号就立即向处理器发出 SAX 事件，
+     *       配合 sax::DomBuilder 可以在每个顶层值闭合时立即得到完整的 Node。
+     *       输入可以是多个顶层值，相邻的顶层值之间必须有空白（通常是换行），1[2] 或 "a""b" 这样紧贴的值视为错误。
+     *       字符串中的控制字符和非法 UTF-8 与 scan_string / validate_utf8 一样被拒绝。
+     */
+    namespace push
+    {
+        /* feed()/finish() 的结果 */
+        enum class Status
+        {
+            NeedMore, ///< 当前块已全部消化，等待更多数据
+            Done,     ///< finish() 时输入恰好在顶层值之间结束
+            Aborted,  ///< 处理器要求终止
+            Error,    ///< 输入格式错误（或 finish() 时输入不完整）
+        };
+
+        /*
+         * 类名: Parser
+         * 描述: 推送式解析器。处理器接口与 sax::Handler 相同。
+         */
+        template <class H>
+        class Parser
+        {
+        public:
+            explicit Parser(H &handler) : handler(handler) {}
+
+            /* 函数名称: feed
+             * 功能描述: 送入下一块数据。块内容在调用返回后即可释放，未完成的记号会被复制到内部缓冲区。
+             */
+            auto feed(std::string_view chunk) -> Status
+            {
+                const char *p = chunk.data();
+                size_t n = chunk.size(), i = 0;
+                while (i < n && status == Status::NeedMore)
+                {
+                    switch (state)
+                    {
+                    case State::String:
+                    {
+                        size_t start = i;
+                        for (; i < n; i++)
+                        {
+                            auto u = static_cast<unsigned char>(p[i]);
+                            if (u < 0x20)
+                                escaped = true; // 与 scan_string 一致：控制字符留给 unescape 报错
+                            else if (u >= 0x80)
+                                non_ascii = true;
+                            if (skip_next)
+                                skip_next = false;
+                            else if (u == '\\')
+                                escaped = skip_next = true;
+                            else if (u == '"')
+                                break;
+                        }
+                        if (i == n)
+                        {
+                            token.append(p + start, n - start); // 字符串跨块，先保存已到达的部分
+                            break;
+                        }
+                        std::string_view raw{p + start, i - start};
+                        if (!token.empty())
+                        {
+                            token.append(raw.data(), raw.size());
+                            raw = token;
+                        }
+                        i++; // 跳过闭引号
+                        finish_string(raw);
+                        break;
+                    }
+                    case State::Number:
+                    case State::Literal:
+                    {
+                        size_t start = i;
+                        while (i < n && (state == State::Number ? is_number_char(p[i]) : is_literal_char(p[i])))
+                            i++;
+                        token.append(p + start, i - start);
+                        if (state == State::Literal && !literal_prefix(token))
+                            fail(); // 不可能再成为合法字面量，不必继续缓存（否则 "tttt…" 会无限增长）
+                        else if (i < n) // 遇到了记号之后的字符，记号完整
+                            state == State::Number ? finish_number() : finish_literal();
+                        break;
+                    }
+                    default:
+                        structural(p[i], i);
+                        break;
+                    }
+                }
+                return status;
+            }
+
+            /* 函数名称: finish
+             * 功能描述: 声明输入结束。结尾处的数字或字面量在此时才能确定已经完整。
+             */
+            auto finish() -> Status
+            {
+                if (status != Status::NeedMore)
+                    return status;
+                if (state == State::Number)
+                    finish_number();
+                else if (state == State::Literal)
+                    finish_literal();
+                if (status == Status::NeedMore)
+                    status = state == State::TopLevel && stack.empty() ? Status::Done : Status::Error;
+                return status;
+            }
+
+            /* 当前未闭合的容器层数 */
+            auto depth() const -> size_t { return stack.size(); }
+
+            /* 允许的最大嵌套层数，超过时 feed() 返回 Error */
+            size_t max_depth = default_max_depth;
+
+        private:
+            enum class State : uint8_t
+            {
+                TopLevel,   ///< 顶层值之间：空白或新的值
+                Value,      ///< 必须是一个值（逗号或冒号之后）
+                ValueOrEnd, ///< '[' 之后：值或 ']'
+                Key,        ///< 对象中逗号之后：必须是键
+                KeyOrEnd,   ///< '{' 之后：键或 '}'
+                Colon,      ///< 键之后：必须是 ':'
+                AfterValue, ///< 容器中的值之后：',' 或闭合符号
+                String,     ///< 字符串内部
+                Number,     ///< 数字内部
+                Literal,    ///< true/false/null 内部
+            };
+
+            static auto is_number_char(char c) -> bool
+            {
+                return unsigned(c - '0') < 10 || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+            }
+            static auto is_literal_char(char c) -> bool { return c >= 'a' && c <= 'z'; }
+
+            /* 记号是否仍是 true、false 或 null 的前缀（因此至多 5 字节） */
+            static auto literal_prefix(std::string_view t) -> bool
+            {
+                for (std::string_view literal : {"true", "false", "null"})
+                    if (literal.substr(0, t.size()) == t)
+                        return true;
+                return false;
+            }
+
+            /* 记录处理器的返回值 */
+            void check(bool keep_going)
+            {
+                if (!keep_going)
+                    status = Status::Aborted;
+            }
+
+            void fail() { status = Status::Error; }
+
+            /* 一个值完成后的状态转移；顶层值完成后，下一个顶层值之前必须出现空白 */
+            void value_done()
+            {
+                state = stack.empty() ? State::TopLevel : State::AfterValue;
+                separated = !stack.empty();
+            }
+
+            /* 函数名称: structural
+             * 功能描述: 处理记号之外的单个字符（空白、括号、逗号、冒号以及值的第一个字符）。
+             */
+            void structural(char c, size_t &i)
+            {
+                if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+                {
+                    i++;
+                    separated = true;
+                    return;
+                }
+                if (state == State::TopLevel && !separated)
+                    return fail(); // 两个顶层值紧贴在一起
+                switch (state)
+                {
+                case State::ValueOrEnd:
+                    if (c == ']')
+                        return close('[', i);
+                    [[fallthrough]];
+                case State::TopLevel:
+                case State::Value:
+                    return start_value(c, i);
+                case State::KeyOrEnd:
+                    if (c == '}')
+                        return close('{', i);
+                    [[fallthrough]];
+                case State::Key:
+                    if (c != '"')
+                        return fail(); // 键必须是字符串
+                    i++;
+                    is_key = true;
+                    state = State::String;
+                    return;
+                case State::Colon:
+                    if (c != ':')
+                        return fail();
+                    i++;
+                    state = State::Value;
+                    return;
+                case State::AfterValue:
+                    if (c == ',')
+                    {
+                        i++;
+                        state = stack.back() == '[' ? State::Value : State::Key;
+                        return;
+                    }
+                    return close(c == ']' ? '[' : c == '}' ? '{'
+                                                           : '\0',
+                                 i);
+                default:
+                    return fail();
+                }
+            }
+
+            /* 函数名称: start_value
+             * 功能描述: 根据值的第一个字符进入相应状态；数字和字面量的第一个字符留给记号状态处理。
+             */
+            void start_value(char c, size_t &i)
+            {
+                switch (c)
+                {
+                case '{':
+                case '[':
+                    if (stack.size() >= max_depth)
+                        return fail(); // 嵌套过深
+                    i++;
+                    stack.push_back(c);
+                    state = c == '{' ? State::KeyOrEnd : State::ValueOrEnd;
+                    return check(c == '{' ? handler.start_object() : handler.start_array());
+                case '"':
+                    i++;
+                    is_key = false;
+                    state = State::String;
+                    return;
+                case 't':
+                case 'f':
+                case 'n':
+                    state = State::Literal;
+                    return;
+                default:
+                    if (c == '-' || unsigned(c - '0') < 10)
+                    {
+                        state = State::Number;
+                        return;
+                    }
+                    return fail();
+                }
+            }
+
+            /* 函数名称: close
+             * 功能描述: 闭合栈顶容器，opener 与栈顶不符时报错。
+             */
+            void close(char opener, size_t &i)
+            {
+                if (stack.empty() || stack.back() != opener)
+                    return fail();
+                i++;
+                stack.pop_back();
+                check(opener == '{' ? handler.end_object() : handler.end_array());
+                value_done();
+            }
+
+            void finish_string(std::string_view raw)
+            {
+                if (non_ascii && !simd::validate_utf8(raw)) // 字符串可能跨块，因此在完整后才校验
+                    return fail();
+                if (escaped)
+                {
+                    scratch.resize(raw.size());
+                    auto len = unescape(raw, scratch.data());
+                    if (!len)
+                        return fail();
+                    raw = std::string_view{scratch.data(), *len};
+                }
+                if (is_key)
+                {
+                    check(handler.on_key(raw));
+                    state = State::Colon;
+                }
+                else
+                {
+                    check(handler.on_string(raw));
+                    value_done();
+                }
+                token.clear();
+                escaped = non_ascii = false;
+            }
+
+            void finish_number()
+            {
+                auto r = number::parse(token.data(), token.data() + token.size());
+                if (r.kind == number::Kind::Error || r.end != token.data() + token.size())
+                    return fail();
+                check(r.kind == number::Kind::Int ? handler.on_int(r.i) : handler.on_double(r.f));
+                token.clear();
+                value_done();
+            }
+
+            void finish_literal()
+            {
+                if (token == "true" || token == "false")
+                    check(handler.on_bool(token == "true"));
+                else if (token == "null")
+                    check(handler.on_null());
+                else
+                    return fail();
+                token.clear();
+                value_done();
+            }
+
+            H &handler;                       ///< 事件处理器
+            std::vector<char> stack;          ///< 未闭合容器的开符号，每层 1 字节
+            State state = State::TopLevel;    ///< 当前状态
+            Status status = Status::NeedMore; ///< 出错或终止后保持不变
+            std::string token;                ///< 跨块的未完成记号
+            std::string scratch;              ///< 转义字符串的解码缓冲区
+            bool is_key = false;              ///< 当前字符串是否为键
+            bool escaped = false;             ///< 当前字符串是否含转义或控制字符
+            bool non_ascii = false;           ///< 当前字符串是否含非 ASCII 字节（需要校验 UTF-8）
+            bool separated = true;            ///< 上一个顶层值之后是否已经出现过空白
+            bool skip_next = false;           ///< 上一个字符是反斜杠（可能在上一块末尾）
+        };
+    }
+
+    /*
+     * 类名: ThreadPool
+     * 描述: 固定大小的线程池。run() 把 [0, tasks) 个任务分发给常驻的工作线程并阻塞到全部完成，
+     *       回调同时收到任务编号和工作线程编号，便于每个线程复用自己的状态。
+     */
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+        {
+            for (size_t i = 0; i < std::max<size_t>(threads, 1); i++)
+            {
+                workers.emplace_back([this, i]
+                                     { worker_loop(i); });
+            }
+        }
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            wake.notify_all();
+            for (auto &t : workers)
+                t.join();
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /* 函数名称: size
+         * 功能描述: 返回工作线程数。
+         */
+        auto size() const -> size_t { return workers.size(); }
+
+        /* 函数名称: run
+         * 功能描述: 并行执行 fn(task, worker)，task 取遍 [0, tasks)，阻塞直到全部完成。
+         *           任务中抛出的第一个异常会在这里重新抛出。
+         */
+        void run(size_t tasks, const std::function<void(size_t, size_t)> &fn)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            job = &fn;
+            job_tasks = tasks;
+            next_task = 0;
+            active = workers.size();
+            error = nullptr;
+            ++generation;
+            wake.notify_all();
+            done.wait(lock, [this]
+                      { return active == 0; });
+            job = nullptr;
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+    private:
+        void worker_loop(size_t id)
+        {
+            uint64_t seen = 0;
+            for (;;)
+            {
+                const std::function<void(size_t, size_t)> *fn;
+                size_t tasks;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wake.wait(lock, [&]
+                              { return stop || generation != seen; });
+                    if (stop)
+                        return;
+                    seen = generation;
+                    fn = job;
+                    tasks = job_tasks;
+                }
+                for (size_t t; (t = next_task.fetch_add(1)) < tasks;)
+                {
+                    try
+                    {
+                        (*fn)(t, id);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error)
+                            error = std::current_exception();
+                    }
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--active == 0)
+                    done.notify_one();
+            }
+        }
+
+        std::vector<std::thread> workers;                          ///< 工作线程
+        std::mutex mutex;                                          ///< 保护以下状态
+        std::condition_variable wake;                              ///< 新任务或停止时唤醒工作线程
+        std::condition_variable done;                              ///< 全部任务完成时唤醒调用者
+        const std::function<void(size_t, size_t)> *job = nullptr; ///< 当前任务
+        size_t job_tasks = 0;                                      ///< 当前任务数
+        std::atomic<size_t> next_task{0};                          ///< 下一个待领取的任务编号
+        size_t active = 0;                                         ///< 尚未完成本轮的工作线程数
+        uint64_t generation = 0;                                   ///< 每次 run() 加一
+        bool stop = false;                                         ///< 析构时置位
+        std::exception_ptr error;                                  ///< 任务中抛出的第一个异常
+    };
+
+    /*
+     * 命名空间: ndjson
+     * 描述: 换行分隔的 JSON（JSON Lines）批量解析。把缓冲区切成按行对齐的块，
+     *       在固定大小的线程池上并行解析，每个工作线程复用自己的结构索引。
+     *       空行（只含空白）会被跳过，不产生结果。
+     */
+    namespace ndjson
+    {
+        /* 函数名称: split_chunks
+         * 功能描述: 把缓冲区切成大约 chunk_bytes 大小的块，每块都在换行符之后结束，保证不会把一行拆开。
+         */
+        inline auto split_chunks(std::string_view buf, size_t chunk_bytes) -> std::vector<std::string_view>
+        {
+            std::vector<std::string_view> chunks;
+            size_t start = 0;
+            while (start < buf.size())
+            {
+                size_t end = std::min(start + std::max<size_t>(chunk_bytes, 1), buf.size());
+                if (end < buf.size())
+                {
+                    auto nl = static_cast<const char *>(std::memchr(buf.data() + end, '\n', buf.size() - end));
+                    end = nl ? size_t(nl - buf.data()) + 1 : buf.size();
+                }
+                chunks.push_back(buf.substr(start, end - start));
+                start = end;
+            }
+            return chunks;
+        }
+
+        /* 函数名称: for_each_line
+         * 功能描述: 依次对块中的每个非空行调用 fn(line, offset_in_chunk)。
+         */
+        template <class F>
+        void for_each_line(std::string_view chunk, F &&fn)
+        {
+            size_t start = 0;
+            while (start < chunk.size())
+            {
+                auto nl = static_cast<const char *>(std::memchr(chunk.data() + start, '\n', chunk.size() - start));
+                size_t end = nl ? size_t(nl - chunk.data()) : chunk.size();
+                std::string_view line = chunk.substr(start, end - start);
+                if (line.find_first_not_of(" \t\r") != line.npos)
+                    fn(line, start);
+                start = end + 1;
+            }
+        }
+
+        /* 解析选项 */
+        struct Options
+        {
+            size_t chunk_bytes = 1 << 20;         ///< 每个任务的目标块大小
+            KeyPool *keys = nullptr;              ///< 可选的共享键池，所有工作线程共用
+            size_t max_depth = default_max_depth; ///< 每行允许的最大嵌套层数
+        };
+
+        /* 函数名称: for_each
+         * 功能描述: 无序模式。每解析完一行就在工作线程上调用 callback(offset, doc)，
+         *           offset 为该行在 buf 中的字节偏移，doc 在该行格式错误时为空。
+         *           callback 会被多个线程并发调用，需自行保证线程安全。
+         */
+        template <class F>
+        void for_each(std::string_view buf, ThreadPool &pool, F &&callback, const Options &options = {})
+        {
+            auto chunks = split_chunks(buf, options.chunk_bytes);
+            std::vector<simd::StructuralIndex> indexes(pool.size()); // 每个工作线程一份，跨行复用
+            pool.run(chunks.size(), [&](size_t task, size_t worker)
+                     {
+                size_t base = size_t(chunks[task].data() - buf.data());
+                for_each_line(chunks[task], [&](std::string_view line, size_t offset)
+                              { callback(base + offset, parser(line, indexes[worker], options.keys, options.max_depth)); }); });
+        }
+
+        /* 函数名称: parse
+         * 功能描述: 有序模式。返回与输入行顺序一致的解析结果（跳过空行），格式错误的行对应空 optional。
+         */
+        inline auto parse(std::string_view buf, ThreadPool &pool, const Options &options = {})
+            -> std::vector<std::optional<Node>>
+        {
+            auto chunks = split_chunks(buf, options.chunk_bytes);
+            std::vector<std::vector<std::optional<Node>>> partial(chunks.size()); // 每块一份，互不竞争
+            std::vector<simd::StructuralIndex> indexes(pool.size());
+            pool.run(chunks.size(), [&](size_t task, size_t worker)
+                     { for_each_line(chunks[task], [&](std::string_view line, size_t)
+                                     { partial[task].push_back(parser(line, indexes[worker], options.keys, options.max_depth)); }); });
+
+            size_t total = 0;
+            for (const auto &part : partial)
+                total += part.size();
+            std::vector<std::optional<Node>> results;
+            results.reserve(total);
+            for (auto &part : partial)
+                std::move(part.begin(), part.end(), std::back_inserter(results));
+            return results;
+        }
+    }
+
+    /*
+     * 类名: JsonWriter
+     * 描述: 单遍 JSON 写出器。所有内容都追加到同一个可增长的缓冲区中：
+     *       目标可以是调用方的 std::string，也可以是 std::ostream 或文件描述符（缓冲区满时整块写出）。
+     *       浮点数使用最短往返格式（std::to_chars，Ryu 类算法），字符串中的引号、反斜杠和控制字符会被正确转义。
+     */
+    class JsonWriter
+    {
+    public:
+        /* 直接追加到调用方的字符串中 */
+        explicit JsonWriter(std::string &out) : buf(out) {}
+
+        /* 写入输出流，缓冲区超过 flush_bytes 时整块写出 */
+        explicit JsonWriter(std::ostream &os, size_t flush_bytes = 64 << 10)
+            : buf(own), stream(&os), flush_bytes(flush_bytes) { own.reserve(flush_bytes + 256); }
+
+#ifdef JSON_HAS_POSIX
+        /* 写入文件描述符，缓冲区超过 flush_bytes 时整块写出 */
+        explicit JsonWriter(int fd, size_t flush_bytes = 64 << 10)
+            : buf(own), fd(fd), flush_bytes(flush_bytes) { own.reserve(flush_bytes + 256); }
+#endif
+
+        ~JsonWriter() { flush(); }
+
+        JsonWriter(const JsonWriter &) = delete;
+        JsonWriter &operator=(const JsonWriter &) = delete;
+
+        /* 函数名称: write
+         * 功能描述: 写出一个节点（递归写出其子节点）。
+         */
+        void write(const Node &node)
+        {
+            std::visit(
+                [this](auto &&arg)
+                {
+                    using T = std::decay_t<decltype(arg)>;
+                    if constexpr (std::is_same_v<T, Null>)
+                        raw("null");
+                    else if constexpr (std::is_same_v<T, Bool>)
+                        raw(arg ? "true" : "false");
+                    else if constexpr (std::is_same_v<T, Int>)
+                        write_int(arg);
+                    else if constexpr (std::is_same_v<T, Float>)
+                        write_float(arg);
+                    else if constexpr (std::is_same_v<T, String>)
+                        write_string(arg);
+                    else if constexpr (std::is_same_v<T, Array>)
+                        write_array(arg);
+                    else if constexpr (std::is_same_v<T, Object>)
+                        write_object(arg);
+                },
+                node.value);
+            maybe_flush();
+        }
+
+        /* 函数名称: write
+         * 功能描述: 写出紧凑 DOM，输出与等价的 json::Node 逐字节相同。
+         */
+        void write(const compact::Node &node)
+        {
+            write_compact(node);
+            maybe_flush();
+        }
+
+        /* 函数名称: write
+         * 功能描述: 写出不可变 DOM，输出与等价的 json::Node 逐字节相同。
+         */
+        void write(const persistent::Node &node)
+        {
+            write_compact(node);
+            maybe_flush();
+        }
+
+        void write_array(const Array &array)
+        {
+            buf += '[';
+            bool first = true;
+            for (const auto &node : array)
+            {
+                if (!first)
+                    buf += ',';
+                first = false;
+                write(node);
+            }
+            buf += ']';
+        }
+
+        void write_object(const Object &object)
+        {
+            buf += '{';
+            bool first = true;
+            for (const auto &[key, node] : object)
+            {
+                if (!first)
+                    buf += ',';
+                first = false;
+                write_string(key);
+                buf += ':';
+                write(node);
+            }
+            buf += '}';
+        }
+
+        /* compact::Node 与 persistent::Node 都以同样的参数调用 visit，共用这一份写出逻辑 */
+        template <class N>
+        void write_compact(const N &node)
+        {
+            node.visit(
+                [this](auto &&arg)
+                {
+                    using T = std::decay_t<decltype(arg)>;
+                    if constexpr (std::is_same_v<T, Null>)
+                        raw("null");
+                    else if constexpr (std::is_same_v<T, Bool>)
+                        raw(arg ? "true" : "false");
+                    else if constexpr (std::is_same_v<T, Int>)
+                        write_int(arg);
+                    else if constexpr (std::is_same_v<T, Float>)
+                        write_float(arg);
+                    else if constexpr (std::is_same_v<T, std::string_view>)
+                        write_string(arg);
+                    else if constexpr (std::is_same_v<T, std::vector<N>>)
+                    {
+                        buf += '[';
+                        for (size_t i = 0; i < arg.size(); i++)
+                        {
+                            if (i)
+                                buf += ',';
+                            write_compact(arg[i]);
+                        }
+                        buf += ']';
+                    }
+                    else
+                    {
+                        buf += '{';
+                        bool first = true;
+                        for (const auto &[key, value] : arg)
+                        {
+                            if (!first)
+                                buf += ',';
+                            first = false;
+                            write_string(key);
+                            buf += ':';
+                            write_compact(value);
+                        }
+                        buf += '}';
+                    }
+                });
+        }
+
+        /* 函数名称: write_int
+         * 功能描述: 用 std::to_chars 直接写入缓冲区，不经过临时字符串。
+         */
+        void write_int(Int v)
+        {
+            char tmp[24];
+            auto r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+            buf.append(tmp, size_t(r.ptr - tmp));
+        }
+
+        /* 函数名称: write_float
+         * 功能描述: 写出能精确往返的最短十进制表示。没有小数点和指数时补上 ".0"，
+         *           以便重新解析后仍是 Float；NaN 和无穷在 JSON 中无法表示，写为 null。
+         */
+        void write_float(Float v)
+        {
+            if (!std::isfinite(v))
+            {
+                raw("null");
+                return;
+            }
+            char tmp[32];
+            auto r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+            size_t n = size_t(r.ptr - tmp);
+            buf.append(tmp, n);
+            if (!std::memchr(tmp, '.', n) && !std::memchr(tmp, 'e', n))
+                raw(".0");
+        }
+
+        /* 函数名称: write_string
+         * 功能描述: 写出带引号并转义后的字符串。不需要转义的连续字节整段追加。
+         */
+        void write_string(std::string_view str)
+        {
+            buf += '"';
+            size_t run = 0; // 当前无需转义的连续片段起点
+            for (size_t i = 0; i < str.size(); i++)
+            {
+                unsigned char c = static_cast<unsigned char>(str[i]);
+                if (c >= 0x20 && c != '"' && c != '\\')
+                    continue;
+                buf.append(str.data() + run, i - run);
+                run = i + 1;
+                switch (c)
+                {
+                case '"':
+                    raw("\\\"");
+                    break;
+                case '\\':
+                    raw("\\\\");
+                    break;
+                case '\b':
+                    raw("\\b");
+                    break;
+                case '\f':
+                    raw("\\f");
+                    break;
+                case '\n':
+                    raw("\\n");
+                    break;
+                case '\r':
+                    raw("\\r");
+                    break;
+                case '\t':
+                    raw("\\t");
+                    break;
+                default:
+                {
+                    static const char hex[] = "0123456789abcdef";
+                    char esc[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 15]};
+                    buf.append(esc, sizeof(esc));
+                }
+                }
+            }
+            buf.append(str.data() + run, str.size() - run);
+            buf += '"';
+        }
+
+        /* 函数名称: raw
+         * 功能描述: 原样追加一段文本。
+         */
+        void raw(std::string_view s) { buf.append(s.data(), s.size()); }
+
+        /* 函数名称: flush
+         * 功能描述: 把缓冲区中的内容写到流或文件描述符（目标是字符串时什么也不做）。部分写出和 EINTR 会重试；
+         *           流进入错误状态或 write 失败时丢弃缓冲区并置错误标志，之后的输出都不再写出。
+         *           析构时的写出无法报告失败，需要确认结果时请先显式调用 flush()。
+         * 返回值: 到目前为止的全部输出都已成功写出时为 true
+         */
+        auto flush() -> bool
+        {
+            if (failed)
+            {
+                own.clear();
+                return false;
+            }
+            if (stream)
+            {
+                stream->write(own.data(), std::streamsize(own.size()));
+                failed = !*stream;
+                own.clear();
+            }
+#ifdef JSON_HAS_POSIX
+            else if (fd >= 0)
+            {
+                size_t done = 0;
+                while (done < own.size())
+                {
+                    ssize_t n = ::write(fd, own.data() + done, own.size() - done);
+                    if (n < 0 && errno == EINTR)
+                        continue;
+                    if (n <= 0)
+                    {
+                        failed = true;
+                        break;
+                    }
+                    done += size_t(n);
+                }
+                own.clear();
+            }
+#endif
+            return !failed;
+        }
+
+        /* 之前的写出是否全部成功；错误标志一旦置位就保持不变 */
+        auto good() const -> bool { return !failed; }
+
+    private:
+        friend class JsonGenerator;
+
+        void maybe_flush()
+        {
+            if (buf.size() >= flush_bytes)
+                flush();
+        }
+
+        /* 函数名称: write_cached
+         * 功能描述: 与 write 相同，但有序列化缓存的数组和对象直接复制缓存的文本；没有缓存的容器写出后，
+         *           文本不短于 min_bytes 时存入该节点的缓存（较小的子树每次重新写出，省去缓存的分配和内存）。
+         *           需要截取刚写出的文本，因此目标必须是字符串：中途 flush 会让 start 失效。为此设为私有，
+         *           只能经 JsonGenerator::generate_cached 以字符串为目标调用。
+         */
+        void write_cached(const Node &node, size_t min_bytes)
+        {
+#if !JSON_NODE_CACHE
+            (void)min_bytes;
+            write(node);
+#else
+            if (auto text = node.cache.get())
+            {
+                raw(*text);
+                return;
+            }
+            size_t start = buf.size();
+            if (auto array = std::get_if<Array>(&node.value))
+            {
+                buf += '[';
+                for (size_t i = 0; i < array->size(); i++)
+                {
+                    if (i)
+                        buf += ',';
+                    write_cached((*array)[i], min_bytes);
+                }
+                buf += ']';
+            }
+            else if (auto object = std::get_if<Object>(&node.value))
+            {
+                buf += '{';
+                bool first = true;
+                for (const auto &[key, value] : *object)
+                {
+                    if (!first)
+                        buf += ',';
+                    first = false;
+                    write_string(key);
+                    buf += ':';
+                    write_cached(value, min_bytes);
+                }
+                buf += '}';
+            }
+            else
+            {
+                write(node);
+                return;
+            }
+            if (buf.size() - start >= min_bytes)
+                node.cache.store(buf.substr(start));
+#endif
+        }
+
+        std::string own;                ///< 流或文件描述符目标时使用的内部缓冲区
+        std::string &buf;               ///< 实际写入的缓冲区
+        std::ostream *stream = nullptr; ///< 输出流目标
+        int fd = -1;                    ///< 文件描述符目标
+        size_t flush_bytes = SIZE_MAX;  ///< 缓冲区达到该大小时写出
+        bool failed = false;            ///< 写出曾经失败（粘滞）
+    };
+
+    /*
+     * 类名: JsonGenerator
+     * 描述: 此类提供了生成 JSON 字符串的方法，根据输入的节点生成相应的 JSON 格式字符串。
+     *       实际的写出由 JsonWriter 单遍完成，嵌套的数组和对象不再各自返回临时字符串。
+     */
+    class JsonGenerator
+    {
+    public:
+        /*
+         * 函数名: generate
+         * 参数: node - 要生成 JSON 字符串的节点
+         * 返回值: 一个字符串，包含了生成的 JSON 数据
+         * 描述: 根据节点生成相应的 JSON 字符串。支持各种类型的节点，如 Null、Bool、Int、Float、String、Array 和 Object。
+         */
+        static auto generate(const Node &node) -> std::string
+        {
+            stats::Section section(stats::Scope::Generate);
+            std::string json_str;
+            JsonWriter(json_str).write(node);
+            count_output(json_str);
+            return json_str;
+        }
+
+        /*
+         * 函数名: generate_cached
+         * 参数: node - 要生成 JSON 字符串的节点
+         *       min_bytes - 文本不短于该长度的数组和对象才会被缓存
+         * 返回值: 与 generate 相同的 JSON 字符串
+         * 描述: 可选的缓存模式。生成时把较大容器的文本缓存在节点上，之后再次生成时直接复用未修改子树的文本，
+         *       只重新写出被修改节点及其祖先（见 Node::cache 的失效规则）。缓存会额外占用内存，
+         *       大约是文本长度乘以缓存容器的嵌套层数。缓存要用 -DJSON_NODE_CACHE=1 编译才启用
+         *       （每个 Node 因此多一个指针），否则与 generate 相同。
+         *       缓存写在 const 节点的 mutable 成员上，因此不能有两个线程同时对同一棵树（或共享子树）调用本函数，
+         *       也不能与修改这棵树的线程并发；需要并发生成时请用 generate。
+         */
+        static auto generate_cached(const Node &node, size_t min_bytes = 128) -> std::string
+        {
+            stats::Section section(stats::Scope::Generate);
+            std::string json_str;
+            JsonWriter(json_str).write_cached(node, min_bytes);
+            count_output(json_str);
+            return json_str;
+        }
+
+        /*
+         * 函数名: generate_string
+         * 参数: str - 要生成 JSON 字符串的字符串
+         * 返回值: 一个字符串，包含了生成的 JSON 字符串
+         * 描述: 根据输入的字符串生成相应的 JSON 字符串。字符串会被包裹在双引号中，并转义特殊字符。
+         */
+        static auto generate_string(const String &str) -> std::string
+        {
+            std::string json_str;
+            JsonWriter(json_str).write_string(str);
+            return json_str;
+        }
+
+        /*
+         * 函数名: generate_array
+         * 参数: array - 要生成 JSON 字符串的数组
+         * 返回值: 一个字符串，包含了生成的 JSON 数组字符串
+         * 描述: 根据输入的数组生成相应的 JSON 数组字符串。
+         */
+        static auto generate_array(const Array &array) -> std::string
+        {
+            std::string json_str;
+            JsonWriter(json_str).write_array(array);
+            return json_str;
+        }
+
+        /*
+         * 函数名: generate_object
+         * 参数: object - 要生成 JSON 字符串的对象
+         * 返回值: 一个字符串，包含了生成的 JSON 对象字符串
+         * 描述: 根据输入的对象生成相应的 JSON 对象字符串。
+         */
+        static auto generate_object(const Object &object) -> std::string
+        {
+            std::string json_str;
+            JsonWriter(json_str).write_object(object);
+            return json_str;
+        }
+
+    private:
+        static void count_output(const std::string &json_str)
+        {
+            if constexpr (stats::enabled)
+            {
+                stats::counters().generate.bytes += json_str.size();
+            }
+        }
+    };
+
+    /*
+     * 函数名: generate
+     * 参数: node - 要生成 JSON 字符串的节点
+     * 返回值: 一个字符串，包含了生成的 JSON 数据
+     * 描述: 调用 JsonGenerator 类的静态方法 generate，生成给定节点的 JSON 字符串，并返回结果。
+     */
     inline auto generate(const Node &node) -> std::string { return JsonGenerator::generate(node); }
 
     /*
-     * 函数名: operator<<
-     * 参数: out - 输出流对象，用于打印 JSON 字符串
-     *       t - 要打印的节点
-     * 返回值: 一个输出流对象的引用，用于支持连续的流操作
-     * 描述: 重载输出流操作符<<，以便能够通过输出流打印给定节点的 JSON 字符串表示。调用 JsonGenerator 类的静态方法 generate，生成节点的 JSON 字符串，并将其写入到输出流 out 中，然后返回输出流 out 的引用，以支持连续的流操作。
+     * 函数名: operator<<
+     * 参数: out - 输出流对象，用于打印 JSON 字符串
+     *       t - 要打印的节点
+     * 返回值: 一个输出流对象的引用，用于支持连续的流操作
+     * 描述: 重载输出流操作符<<，以便能够通过输出流打印给定节点的 JSON 字符串表示。由 JsonWriter 分块写入输出流 out 中，然后返回输出流 out 的引用，以支持连续的流操作。
+     */
+    auto operator<<(std::ostream &out, const Node &t) -> std::ostream &
+    {
+        JsonWriter(out).write(t); // 直接写入流，不再生成完整的中间字符串
+        return out;
+    }
+
+    /*
+     * 类名: ParallelGenerator
+     * 描述: 可选的并行生成器。先沿着树规划出一串有序的片段：元素不少于 2 * min_elements 个的数组或对象
+     *       按元素区间切成若干任务，其余部分（括号、键和较小的子树）在规划时顺序写出。
+     *       各任务在线程池上写进自己的缓冲区，最后按顺序拼接，或用 writev 直接写到文件描述符。
+     *       每个片段都由 JsonWriter 的同一组函数写出，因此输出与 JsonGenerator::generate 逐字节相同。
+     *       同一个 ParallelGenerator 不能被多个线程同时使用。
+     */
+    class ParallelGenerator
+    {
+    public:
+        explicit ParallelGenerator(ThreadPool &pool, size_t min_elements = 1024)
+            : pool(pool), min_elements(std::max<size_t>(min_elements, 1)) {}
+
+        /* 函数名称: generate
+         * 功能描述: 并行生成 node 的 JSON 文本。
+         */
+        auto generate(const Node &node) -> std::string
+        {
+            render(node);
+            std::string json_str;
+            json_str.reserve(total);
+            for (const auto &piece : pieces)
+                json_str += piece.text;
+            pieces.clear();
+            return json_str;
+        }
+
+#ifdef JSON_HAS_POSIX
+        /* 函数名称: write
+         * 功能描述: 并行生成后用 writev 把各片段按顺序写到文件描述符，省去拼接时的复制。写出失败时返回 false。
+         */
+        auto write(int fd, const Node &node) -> bool
+        {
+            render(node);
+            std::vector<iovec> iov;
+            iov.reserve(pieces.size());
+            for (auto &piece : pieces)
+                if (!piece.text.empty())
+                    iov.push_back({piece.text.data(), piece.text.size()});
+            bool ok = write_all(fd, iov);
+            pieces.clear();
+            return ok;
+        }
+#endif
+
+    private:
+        /* 有序片段：文本片段在规划时写好；任务片段对应某个容器的元素区间 [begin, end)，由工作线程写出 */
+        struct Piece
+        {
+            std::string text;
+            const Array *array = nullptr;
+            const Object *object = nullptr;
+            size_t begin = 0, end = 0;
+
+            auto is_task() const -> bool { return array || object; }
+        };
+
+        /* 规划时最多向下查找大容器的层数，更深的子树直接顺序写出 */
+        static constexpr size_t descend_depth = 4;
+
+        /* 函数名称: render
+         * 功能描述: 规划片段并在线程池上写出全部任务片段。
+         */
+        void render(const Node &node)
+        {
+            pieces.clear();
+            plan(node, 0);
+            std::vector<size_t> tasks;
+            for (size_t i = 0; i < pieces.size(); i++)
+                if (pieces[i].is_task())
+                    tasks.push_back(i);
+            if (!tasks.empty())
+                pool.run(tasks.size(), [&](size_t task, size_t)
+                         { write_range(pieces[tasks[task]]); });
+            total = 0;
+            for (const auto &piece : pieces)
+                total += piece.text.size();
+        }
+
+        /* 当前的文本片段；最后一个片段是任务时另起一个 */
+        auto text() -> std::string &
+        {
+            if (pieces.empty() || pieces.back().is_task())
+                pieces.emplace_back();
+            return pieces.back().text;
+        }
+
+        void plan(const Node &node, size_t depth)
+        {
+            if (auto array = std::get_if<Array>(&node.value))
+            {
+                if (array->size() >= 2 * min_elements)
+                    return split(array, nullptr, array->size(), '[', ']');
+                if (depth < descend_depth)
+                {
+                    text() += '[';
+                    for (size_t i = 0; i < array->size(); i++)
+                    {
+                        if (i)
+                            text() += ',';
+                        plan((*array)[i], depth + 1);
+                    }
+                    text() += ']';
+                    return;
+                }
+            }
+            else if (auto object = std::get_if<Object>(&node.value))
+            {
+                if (object->size() >= 2 * min_elements)
+                    return split(nullptr, object, object->size(), '{', '}');
+                if (depth < descend_depth)
+                {
+                    text() += '{';
+                    bool first = true;
+                    for (const auto &[key, value] : *object)
+                    {
+                        if (!first)
+                            text() += ',';
+                        first = false;
+                        JsonWriter(text()).write_string(key);
+                        text() += ':';
+                        plan(value, depth + 1);
+                    }
+                    text() += '}';
+                    return;
+                }
+            }
+            JsonWriter(text()).write(node);
+        }
+
+        /* 把一个大容器按元素个数切成若干任务；任务数取线程数的 4 倍以平衡元素大小不均 */
+        void split(const Array *array, const Object *object, size_t n, char open, char close)
+        {
+            text() += open;
+            size_t tasks = std::max<size_t>(2, std::min(n / min_elements, pool.size() * 4));
+            for (size_t k = 0; k < tasks; k++)
+            {
+                Piece piece;
+                piece.array = array;
+                piece.object = object;
+                piece.begin = n * k / tasks;
+                piece.end = n * (k + 1) / tasks;
+                pieces.push_back(std::move(piece));
+            }
+            text() += close;
+        }
+
+        /* 函数名称: write_range
+         * 功能描述: 在工作线程上写出一个任务片段。区间不在容器开头时以逗号开始，拼接后与顺序写出完全一致。
+         */
+        static void write_range(Piece &piece)
+        {
+            JsonWriter w(piece.text);
+            for (size_t i = piece.begin; i < piece.end; i++)
+            {
+                if (i)
+                    w.raw(",");
+                if (piece.array)
+                {
+                    w.write((*piece.array)[i]);
+                }
+                else
+                {
+                    const auto &[key, value] = *(piece.object->begin() + i);
+                    w.write_string(key);
+                    w.raw(":");
+                    w.write(value);
+                }
+            }
+        }
+
+#ifdef JSON_HAS_POSIX
+        /* 函数名称: write_all
+         * 功能描述: 循环调用 writev 直到全部写出，处理部分写出和 EINTR。
+         */
+        static auto write_all(int fd, std::vector<iovec> &iov) -> bool
+        {
+#ifdef IOV_MAX
+            constexpr size_t max_iov = IOV_MAX;
+#else
+            constexpr size_t max_iov = 1024;
+#endif
+            size_t i = 0;
+            while (i < iov.size())
+            {
+                ssize_t n = ::writev(fd, &iov[i], int(std::min(iov.size() - i, max_iov)));
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    return false;
+                }
+                size_t left = size_t(n);
+                while (i < iov.size() && left >= iov[i].iov_len)
+                    left -= iov[i++].iov_len;
+                if (left)
+                {
+                    iov[i].iov_base = static_cast<char *>(iov[i].iov_base) + left;
+                    iov[i].iov_len -= left;
+                }
+            }
+            return true;
+        }
+#endif
+
+        ThreadPool &pool;          ///< 执行任务片段的线程池
+        size_t min_elements;       ///< 每个任务至少包含的元素个数
+        std::vector<Piece> pieces; ///< 按输出顺序排列的片段
+        size_t total = 0;          ///< 全部片段的总字节数
+    };
+
+    /*
+     * 命名空间: binary
+     * 描述: 基于偏移的二进制格式，由 BinaryGenerator 写出。读取时把文件映射进内存后直接在原处遍历，
+     *       不做反序列化：每个值以 1 字节标签开头，容器头部带有元素个数、整个值的字节数和各元素的相对偏移表，
+     *       因此按下标访问和跳过子树都是 O(1)。对象的键统一存放在文件末尾的键表中，成员只记录 uint32 键编号，
+     *       重复出现的键只存一次。数值按主机字节序存储（文件只在同一字节序的机器间共享），字符串按原样存储，
+     *       与 json::Node 互相转换没有损失（整数与浮点数的区别、浮点数的每一位、成员顺序都保留）。
+     *
+     *       文件布局: "JSNB" + uint32 版本号 + uint64 键表偏移，随后是根值，最后是键表。
+     *         null/false/true  标签
+     *         整数             标签 + 4 字节（能用 int32 表示时）或 8 字节
+     *         浮点数           标签 + 8 字节
+     *         字符串           标签 + uint32 长度 + 内容
+     *         数组             标签 + uint32 个数 + uint32 字节数 + uint32 偏移[个数]，偏移相对于值的起点
+     *         对象             同数组，偏移指向成员：uint32 键编号 + 值
+     *         键表             uint32 个数 + uint32 偏移[个数]（相对于键表起点），每个键为 uint32 长度 + 内容
+     */
+    namespace binary
+    {
+        /* 每个值的第一个字节 */
+        enum class Tag : uint8_t
+        {
+            Null,
+            False,
+            True,
+            Int32,
+            Int64,
+            Float,
+            String,
+            Array,
+            Object,
+        };
+
+        constexpr char magic[4] = {'J', 'S', 'N', 'B'};
+        constexpr uint32_t version = 1;
+        constexpr size_t header_size = sizeof(magic) + sizeof(uint32_t) + sizeof(uint64_t);
+        constexpr size_t container_header = 1 + 2 * sizeof(uint32_t); ///< 标签 + 个数 + 字节数
+
+        /*
+         * 结构体: Buffer
+         * 描述: 映射内存的视图和键表位置，所有 Value 共享。带边界检查的读取：
+         *       损坏的文件会抛出 std::runtime_error 而不是越界访问。
+         */
+        struct Buffer
+        {
+            const char *data = nullptr;
+            size_t size = 0;
+            size_t keys = 0; ///< 键表的偏移
+
+            template <class T>
+            auto load(size_t at) const -> T
+            {
+                if (at > size || size - at < sizeof(T))
+                    throw std::runtime_error("corrupt binary: offset out of range");
+                T v;
+                std::memcpy(&v, data + at, sizeof(T));
+                return v;
+            }
+
+            /* 位于 at 处、带 uint32 长度前缀的文本 */
+            auto text(size_t at) const -> std::string_view
+            {
+                uint32_t len = load<uint32_t>(at);
+                if (size - at - sizeof(uint32_t) < len)
+                    throw std::runtime_error("corrupt binary: offset out of range");
+                return {data + at + sizeof(uint32_t), len};
+            }
+
+            /* 编号为 id 的键 */
+            auto key(uint32_t id) const -> std::string_view
+            {
+                if (id >= load<uint32_t>(keys))
+                    throw std::runtime_error("corrupt binary: key id out of range");
+                return text(keys + load<uint32_t>(keys + sizeof(uint32_t) * (1 + size_t(id))));
+            }
+        };
+
+        /*
+         * 类名: Value
+         * 描述: 指向映射内存中某个值的游标（共享的 Buffer 指针和偏移），可以随意按值传递，
+         *       只在 Buffer（通常由 File 持有）存活期间有效。访问失败时与 Node 一样抛出 std::runtime_error。
+         */
+        class Value
+        {
+        public:
+            Value(const Buffer *buf, size_t offset) : buf(buf), offset(offset) {}
+
+            auto tag() const -> Tag { return Tag(buf->load<uint8_t>(offset)); }
+            auto is_null() const -> bool { return tag() == Tag::Null; }
+            auto is_bool() const -> bool { return tag() == Tag::False || tag() == Tag::True; }
+            auto is_int() const -> bool { return tag() == Tag::Int32 || tag() == Tag::Int64; }
+            auto is_float() const -> bool { return tag() == Tag::Float; }
+            auto is_string() const -> bool { return tag() == Tag::String; }
+            auto is_array() const -> bool { return tag() == Tag::Array; }
+            auto is_object() const -> bool { return tag() == Tag::Object; }
+
+            auto get_bool() const -> Bool
+            {
+                if (!is_bool())
+                    throw std::runtime_error("not a bool");
+                return tag() == Tag::True;
+            }
+            auto get_int() const -> Int
+            {
+                switch (tag())
+                {
+                case Tag::Int32:
+                    return buf->load<int32_t>(offset + 1);
+                case Tag::Int64:
+                    return buf->load<Int>(offset + 1);
+                default:
+                    throw std::runtime_error("not an integer");
+                }
+            }
+            auto get_double() const -> Float
+            {
+                if (is_int())
+                    return Float(get_int());
+                if (!is_float())
+                    throw std::runtime_error("not a number");
+                return buf->load<Float>(offset + 1);
+            }
+            /* 字符串内容的视图，指向映射内存 */
+            auto get_string() const -> std::string_view
+            {
+                if (!is_string())
+                    throw std::runtime_error("not a string");
+                return buf->text(offset + 1);
+            }
+
+            /* 数组元素或对象成员的个数；其他类型为 0 */
+            auto size() const -> size_t
+            {
+                if (!is_array() && !is_object())
+                    return 0;
+                size_t n = buf->load<uint32_t>(offset + 1);
+                size_t total = bytes();
+                if (total < container_header || (total - container_header) / sizeof(uint32_t) < n || total > buf->size - offset)
+                    throw std::runtime_error("corrupt binary: container size out of range");
+                return n;
+            }
+
+            /* 整个值（含子树）占用的字节数 */
+            auto bytes() const -> size_t
+            {
+                switch (tag())
+                {
+                case Tag::Int32:
+                    return 1 + sizeof(int32_t);
+                case Tag::Int64:
+                case Tag::Float:
+                    return 1 + sizeof(Int);
+                case Tag::String:
+                    return 1 + sizeof(uint32_t) + buf->load<uint32_t>(offset + 1);
+                case Tag::Array:
+                case Tag::Object:
+                    return buf->load<uint32_t>(offset + 1 + sizeof(uint32_t));
+                default:
+                    return 1;
+                }
+            }
+
+            auto operator[](size_t index) const -> Value
+            {
+                if (!is_array())
+                    throw std::runtime_error("not an array");
+                if (index >= size())
+                    throw std::out_of_range("index out of range");
+                return Value{buf, element(index)};
+            }
+
+            /* 函数名称: find
+             * 功能描述: 在对象的成员中按键查找，找不到时返回空 optional。
+             */
+            auto find(std::string_view key) const -> std::optional<Value>
+            {
+                if (!is_object())
+                    throw std::runtime_error("not an object");
+                for (size_t i = 0, n = size(); i < n; i++)
+                {
+                    size_t member = element(i);
+                    if (buf->key(buf->load<uint32_t>(member)) == key)
+                        return Value{buf, member + sizeof(uint32_t)};
+                }
+                return {};
+            }
+
+            auto operator[](std::string_view key) const -> Value
+            {
+                auto value = find(key);
+                if (!value)
+                    throw std::runtime_error("key not found");
+                return *value;
+            }
+
+            /*
+             * 类名: Iterator
+             * 描述: 依次访问数组元素或对象成员（对象时可用 key() 取得键）。
+             */
+            class Iterator
+            {
+            public:
+                Iterator(const Buffer *buf, size_t container, size_t index) : buf(buf), container(container), index(index) {}
+                auto operator*() const -> Value
+                {
+                    Value owner{buf, container};
+                    size_t at = owner.element(index);
+                    return Value{buf, owner.is_object() ? at + sizeof(uint32_t) : at};
+                }
+                auto key() const -> std::string_view
+                {
+                    return buf->key(buf->load<uint32_t>(Value{buf, container}.element(index)));
+                }
+                auto operator++() -> Iterator &
+                {
+                    ++index;
+                    return *this;
+                }
+                auto operator==(const Iterator &rhs) const -> bool { return index == rhs.index; }
+                auto operator!=(const Iterator &rhs) const -> bool { return index != rhs.index; }
+
+            private:
+                const Buffer *buf;
+                size_t container; ///< 所在容器的偏移
+                size_t index;     ///< 当前元素的下标
+            };
+
+            auto begin() const -> Iterator { return Iterator{buf, offset, 0}; }
+            auto end() const -> Iterator { return Iterator{buf, offset, size()}; }
+
+            /* 函数名称: to_node
+             * 功能描述: 物化为 json::Node（只在确实需要可修改的树时使用）。
+             *           与解析器一样限制嵌套层数，超过 max_depth 层时抛出 std::runtime_error。
+             */
+            auto to_node(size_t max_depth = default_max_depth) const -> Node
+            {
+                switch (tag())
+                {
+                case Tag::Null:
+                    return Node{};
+                case Tag::False:
+                case Tag::True:
+                    return Node{get_bool()};
+                case Tag::Int32:
+                case Tag::Int64:
+                    return Node{get_int()};
+                case Tag::Float:
+                    return Node{get_double()};
+                case Tag::String:
+                    return Node{String{get_string()}};
+                case Tag::Array:
+                {
+                    if (max_depth == 0)
+                        throw std::runtime_error("nesting too deep");
+                    Array arr;
+                    arr.reserve(size());
+                    for (auto it = begin(); it != end(); ++it)
+                        arr.push_back((*it).to_node(max_depth - 1));
+                    return Node{std::move(arr)};
+                }
+                case Tag::Object:
+                {
+                    if (max_depth == 0)
+                        throw std::runtime_error("nesting too deep");
+                    Object obj;
+                    obj.reserve(size());
+                    for (auto it = begin(); it != end(); ++it)
+                        obj.insert_or_assign(std::string{it.key()}, (*it).to_node(max_depth - 1));
+                    return Node{std::move(obj)};
+                }
+                }
+                throw std::runtime_error("corrupt binary: unknown tag");
+            }
+
+        private:
+            /* 第 index 个元素（或成员）的绝对偏移；偏移必须落在容器的偏移表之后、容器之内，
+             * 因此损坏的文件不会让遍历回到祖先节点 */
+            auto element(size_t index) const -> size_t
+            {
+                size_t rel = buf->load<uint32_t>(offset + container_header + index * sizeof(uint32_t));
+                if (rel < container_header + size() * sizeof(uint32_t) || rel >= bytes())
+                    throw std::runtime_error("corrupt binary: offset out of range");
+                return offset + rel;
+            }
+
+            const Buffer *buf; ///< 所在的缓冲区
+            size_t offset;     ///< 值在缓冲区中的偏移
+        };
+
+        /*
+         * 类名: File
+         * 描述: 映射一个二进制文件并直接在映射上访问，打开的代价与文件大小无关。
+         *       也可以包装一个已在内存中的二进制文档（调用方保证其有效）。Value 只在 File 存活期间有效，
+         *       因此创建 Value 之后不要移动 File。
+         */
+        class File
+        {
+        public:
+            explicit File(const std::string &path) : file(path)
+            {
+                if (file)
+                    open(file.data());
+            }
+            explicit File(std::string_view bytes) { open(bytes); }
+
+            File(const File &) = delete;
+            File &operator=(const File &) = delete;
+
+            /* 根值的游标；文件无法打开或格式不对时为空 */
+            auto root() const -> std::optional<Value>
+            {
+                if (!valid)
+                    return {};
+                return Value{&buf, header_size};
+            }
+
+        private:
+            /* 检查文件头、键表位置和根值的长度 */
+            void open(std::string_view bytes)
+            {
+                buf = Buffer{bytes.data(), bytes.size(), 0};
+                if (bytes.size() <= header_size || std::memcmp(bytes.data(), magic, sizeof(magic)) != 0 ||
+                    buf.load<uint32_t>(sizeof(magic)) != version)
+                    return;
+                uint64_t keys = buf.load<uint64_t>(sizeof(magic) + sizeof(uint32_t));
+                if (keys > bytes.size() - sizeof(uint32_t) || keys < header_size)
+                    return;
+                buf.keys = size_t(keys);
+                try
+                {
+                    valid = Value{&buf, header_size}.bytes() <= buf.keys - header_size;
+                }
+                catch (const std::runtime_error &)
+                {
+                    valid = false;
+                }
+            }
+
+            MappedFile file{""}; ///< 从路径打开时持有映射
+            Buffer buf;          ///< 文档的视图和键表位置
+            bool valid = false;  ///< 文件头是否有效
+        };
+    }
+
+    /*
+     * 类名: BinaryGenerator
+     * 描述: JsonGenerator 的二进制版本，按 binary 命名空间中描述的布局写出 Node。
+     *       容器的偏移表先占位，写完子节点后回填；单个容器或键表超过 4GB 时抛出 std::length_error。
+     */
+    class BinaryGenerator
+    {
+    public:
+        /*
+         * 函数名: generate
+         * 参数: node - 要编码的节点
+         * 返回值: 带文件头和键表的完整二进制文档
+         */
+        static auto generate(const Node &node) -> std::string
+        {
+            BinaryGenerator g;
+            g.out.assign(binary::magic, sizeof(binary::magic));
+            g.append(binary::version);
+            g.append(uint64_t(0)); // 键表偏移，写完根值后回填
+            g.write(node);
+            g.patch(sizeof(binary::magic) + sizeof(uint32_t), uint64_t(g.out.size()));
+            g.write_keys();
+            return std::move(g.out);
+        }
+
+        /*
+         * 函数名: save
+         * 参数: path - 目标文件；node - 要编码的节点
+         * 返回值: 写入成功时为 true
+         */
+        static auto save(const std::string &path, const Node &node) -> bool
+        {
+            std::string bytes = generate(node);
+            std::ofstream fout(path, std::ios::binary | std::ios::trunc);
+            fout.write(bytes.data(), std::streamsize(bytes.size()));
+            return bool(fout);
+        }
+
+        /*
+         * 函数名: from_json
+         * 参数: json_str - JSON 文本
+         * 返回值: 对应的二进制文档；文本格式错误时为空
+         */
+        static auto from_json(std::string_view json_str) -> std::optional<std::string>
+        {
+            auto node = parser(json_str);
+            if (!node)
+                return {};
+            return generate(*node);
+        }
+
+    private:
+        std::string out;                                ///< 输出缓冲区
+        std::vector<std::string_view> keys;             ///< 按编号排列的键（指向被编码的 Node）
+        std::unordered_map<std::string_view, uint32_t> ids; ///< 键 -> 编号
+
+        template <class T>
+        void append(T v) { out.append(reinterpret_cast<const char *>(&v), sizeof(T)); }
+
+        template <class T>
+        void patch(size_t at, T v) { std::memcpy(&out[at], &v, sizeof(T)); }
+
+        static auto narrow(size_t n) -> uint32_t
+        {
+            if (n > UINT32_MAX)
+                throw std::length_error("binary container larger than 4GB");
+            return uint32_t(n);
+        }
+
+        void append_text(std::string_view s)
+        {
+            append(narrow(s.size()));
+            out.append(s.data(), s.size());
+        }
+
+        auto key_id(std::string_view key) -> uint32_t
+        {
+            auto [it, inserted] = ids.try_emplace(key, narrow(keys.size()));
+            if (inserted)
+                keys.push_back(key);
+            return it->second;
+        }
+
+        void write_keys()
+        {
+            size_t start = out.size();
+            append(narrow(keys.size()));
+            size_t table = out.size();
+            out.resize(table + keys.size() * sizeof(uint32_t));
+            for (size_t i = 0; i < keys.size(); i++)
+            {
+                patch(table + i * sizeof(uint32_t), narrow(out.size() - start));
+                append_text(keys[i]);
+            }
+        }
+
+        void write(const Node &node)
+        {
+            size_t start = out.size();
+            std::visit(
+                [&](auto &&arg)
+                {
+                    using T = std::decay_t<decltype(arg)>;
+                    if constexpr (std::is_same_v<T, Null>)
+                        out += char(binary::Tag::Null);
+                    else if constexpr (std::is_same_v<T, Bool>)
+                        out += char(arg ? binary::Tag::True : binary::Tag::False);
+                    else if constexpr (std::is_same_v<T, Int>)
+                    {
+                        if (arg >= INT32_MIN && arg <= INT32_MAX)
+                        {
+                            out += char(binary::Tag::Int32);
+                            append(int32_t(arg));
+                        }
+                        else
+                        {
+                            out += char(binary::Tag::Int64);
+                            append(arg);
+                        }
+                    }
+                    else if constexpr (std::is_same_v<T, Float>)
+                    {
+                        out += char(binary::Tag::Float);
+                        append(arg);
+                    }
+                    else if constexpr (std::is_same_v<T, String>)
+                    {
+                        out += char(binary::Tag::String);
+                        append_text(arg);
+                    }
+                    else
+                    {
+                        constexpr bool is_array = std::is_same_v<T, Array>;
+                        out += char(is_array ? binary::Tag::Array : binary::Tag::Object);
+                        append(narrow(arg.size()));
+                        append(uint32_t(0)); // 字节数，写完子节点后回填
+                        size_t table = out.size();
+                        out.resize(table + arg.size() * sizeof(uint32_t));
+                        size_t i = 0;
+                        for (const auto &element : arg)
+                        {
+                            patch(table + i++ * sizeof(uint32_t), narrow(out.size() - start));
+                            if constexpr (is_array)
+                                write(element);
+                            else
+                            {
+                                append(key_id(element.first));
+                                write(element.second);
+                            }
+                        }
+                        patch(start + 1 + sizeof(uint32_t), narrow(out.size() - start));
+                    }
+                },
+                node.value);
+        }
+    };
+
+    /* 紧凑 DOM 的生成与输出，结果与 json::Node 相同 */
+    inline auto generate(const compact::Node &node) -> std::string
+    {
+        std::string json_str;
+        JsonWriter(json_str).write(node);
+        return json_str;
+    }
+
+    namespace compact
+    {
+        inline auto operator<<(std::ostream &out, const Node &t) -> std::ostream &
+        {
+            JsonWriter(out).write(t);
+            return out;
+        }
+    }
+
+    /* 不可变 DOM 的生成与输出，结果与 json::Node 相同 */
+    inline auto generate(const persistent::Node &node) -> std::string
+    {
+        std::string json_str;
+        JsonWriter(json_str).write(node);
+        return json_str;
+    }
+
+    namespace persistent
+    {
+        inline auto operator<<(std::ostream &out, const Node &t) -> std::ostream &
+        {
+            JsonWriter(out).write(t);
+            return out;
+        }
+    }
+
+    /*
+     * 命名空间: bind
+     * 描述: 编译期类型绑定。为结构体声明一张字段表（键名 + 成员指针）之后，
+     *       bind::parse 直接把 JSON 写进结构体成员，bind::to_json 反向写出，中间不构建任何 Node。
+     *       字段表可以写成结构体的静态成员 json_fields，也可以特化 bind::Fields<T>：
+     *
+     *           struct Address { std::string city, street;
+     *               static constexpr auto json_fields = std::make_tuple(
+     *                   json::bind::field("city", &Address::city), json::bind::field("street", &Address::street)); };
+     *
+     *       支持的成员类型：bool、整数、浮点数、std::string、std::optional<U>、std::vector<U>、
+     *       已绑定的结构体以及 json::Node（原样保留任意 JSON）。缺失的键保留成员原值，未知的键被跳过。
+     */
+    namespace bind
+    {
+        /*
+         * 结构体: Field
+         * 描述: 字段表的一项：JSON 键名与对应的成员指针。
+         */
+        template <class T, class M>
+        struct Field
+        {
+            std::string_view name;
+            M T::*member;
+        };
+
+        template <class T, class M>
+        constexpr auto field(std::string_view name, M T::*member) -> Field<T, M> { return {name, member}; }
+
+        /* 字段表：默认取 T::json_fields，也可以为不便修改的类型直接特化 */
+        template <class T, class = void>
+        struct Fields
+        {
+        };
+        template <class T>
+        struct Fields<T, std::void_t<decltype(T::json_fields)>>
+        {
+            static constexpr const auto &value = T::json_fields;
+        };
+
+        template <class T, class = void>
+        struct is_bound : std::false_type
+        {
+        };
+        template <class T>
+        struct is_bound<T, std::void_t<decltype(Fields<T>::value)>> : std::true_type
+        {
+        };
+
+        template <class T>
+        struct is_vector : std::false_type
+        {
+        };
+        template <class U, class A>
+        struct is_vector<std::vector<U, A>> : std::true_type
+        {
+        };
+
+        template <class T>
+        struct is_optional : std::false_type
+        {
+        };
+        template <class U>
+        struct is_optional<std::optional<U>> : std::true_type
+        {
+        };
+
+        template <class T>
+        constexpr size_t field_count = std::tuple_size_v<std::decay_t<decltype(Fields<T>::value)>>;
+
+        /*
+         * 结构体: Reader
+         * 描述: 按目标类型驱动的解析器。复用 JsonParser 的结构索引、字符串定位和数字内核；
+         *       对象的键在编译期展开成一串比较，并优先尝试声明顺序中的下一个字段。
+         */
+        struct Reader
+        {
+            JsonParser p;            ///< 负责位置推进与标量解析（要求已设置结构索引）
+            std::string scratch{};   ///< 转义键的解码缓冲区
+            std::string closers{};   ///< skip 中尚未闭合的容器各自期待的结束括号
+
+            auto peek() const -> char { return p.pos < p.json_str.size() ? p.json_str[p.pos] : '\0'; }
+
+            /* 函数名称: string
+             * 功能描述: 读取一个字符串，无转义时返回源文本视图，有转义时解码到 buffer。
+             */
+            auto string(std::string &buffer) -> std::optional<std::string_view>
+            {
+                if (peek() != '"')
+                    return {};
+                bool escaped;
+                auto raw = p.scan_string(escaped);
+                if (!raw || !escaped)
+                    return raw;
+                buffer.resize(raw->size());
+                auto len = unescape(*raw, buffer.data());
+                if (!len)
+                    return {};
+                buffer.resize(*len);
+                return std::string_view{buffer};
+            }
+
+            /* 函数名称: skip_scalar
+             * 功能描述: 校验并跳过一个标量；字符串只在含转义时解码到 scratch，不构造 Value。
+             */
+            auto skip_scalar() -> bool
+            {
+                char c = peek();
+                if (c == '"')
+                    return string(scratch).has_value();
+                if (c == '\0')
+                    return false;
+                return p.parse_scalar().has_value();
+            }
+
+            /* 跳过对象成员的键和冒号 */
+            auto skip_key() -> bool
+            {
+                p.parse_whitespace();
+                if (!string(scratch))
+                    return false;
+                p.parse_whitespace();
+                if (peek() != ':')
+                    return false;
+                p.pos++;
+                return true;
+            }
+
+            /* 函数名称: skip
+             * 功能描述: 跳过未知键的值。与 JsonParser::parse_tree 相同的非递归遍历，只是不构造节点：
+             *           括号必须配对、键和分隔符必须合法、标量照常校验，因此未知键中的语法错误同样使解析失败。
+             */
+            auto skip() -> bool
+            {
+                closers.clear();
+                for (;;)
+                {
+                    p.parse_whitespace();
+                    char c = peek();
+                    if (c == '[' || c == '{')
+                    {
+                        if (closers.size() >= p.max_depth)
+                        {
+                            p.depth_exceeded = true;
+                            return false;
+                        }
+                        p.pos++;
+                        closers.push_back(c == '[' ? ']' : '}');
+                        p.parse_whitespace();
+                        if (peek() != closers.back())
+                        {
+                            if (c == '{' && !skip_key())
+                                return false;
+                            continue;
+                        }
+                        p.pos++; // 空容器
+                        closers.pop_back();
+                    }
+                    else if (!skip_scalar())
+                        return false;
+
+                    // 一个值已经完整：逐层处理其后的逗号或结束括号
+                    for (;;)
+                    {
+                        if (closers.empty())
+                            return true;
+                        p.parse_whitespace();
+                        char d = peek();
+                        if (d == ',')
+                        {
+                            p.pos++;
+                            if (closers.back() == '}' && !skip_key())
+                                return false;
+                            break;
+                        }
+                        if (d != closers.back())
+                            return false;
+                        p.pos++;
+                        closers.pop_back();
+                    }
+                }
+            }
+
+            /* 函数名称: read
+             * 功能描述: 按 T 的类型读取一个值到 out。
+             * 返回值: false 表示语法错误或类型不匹配
+             */
+            template <class T>
+            auto read(T &out) -> bool
+            {
+                p.parse_whitespace();
+                if constexpr (std::is_same_v<T, bool>)
+                {
+                    if (peek() == 't' && p.parse_true())
+                        out = true;
+                    else if (peek() == 'f' && p.parse_false())
+                        out = false;
+                    else
+                        return false;
+                    return true;
+                }
+                else if constexpr (std::is_integral_v<T>)
+                {
+                    const char *begin = p.json_str.data() + p.pos, *end = p.json_str.data() + p.json_str.size();
+                    auto n = number::parse(begin, end);
+                    if (n.kind != number::Kind::Int)
+                    {
+                        if constexpr (std::is_unsigned_v<T> && sizeof(T) == 8) // 超出 int64 的无符号整数
+                        {
+                            auto r = std::from_chars(begin, end, out);
+                            if (r.ec != std::errc{} || !p.at_delimiter(size_t(r.ptr - p.json_str.data())))
+                                return false;
+                            p.pos += size_t(r.ptr - begin);
+                            return true;
+                        }
+                        return false;
+                    }
+                    if (!p.at_delimiter(size_t(n.end - p.json_str.data()))) // 与 parse_number 相同，拒绝 "12x"
+                        return false;
+                    if constexpr (std::is_unsigned_v<T>)
+                    {
+                        if (n.i < 0 || uint64_t(n.i) > std::numeric_limits<T>::max())
+                            return false;
+                    }
+                    else if (n.i < std::numeric_limits<T>::min() || n.i > std::numeric_limits<T>::max())
+                        return false;
+                    out = T(n.i);
+                    p.pos += size_t(n.end - begin);
+                    return true;
+                }
+                else if constexpr (std::is_floating_point_v<T>)
+                {
+                    const char *begin = p.json_str.data() + p.pos;
+                    auto n = number::parse(begin, p.json_str.data() + p.json_str.size());
+                    if (n.kind == number::Kind::Error || !p.at_delimiter(size_t(n.end - p.json_str.data())))
+                        return false;
+                    out = T(n.kind == number::Kind::Int ? Float(n.i) : n.f);
+                    p.pos += size_t(n.end - begin);
+                    return true;
+                }
+                else if constexpr (std::is_same_v<T, std::string>)
+                {
+                    if (peek() != '"')
+                        return false;
+                    bool escaped;
+                    auto raw = p.scan_string(escaped);
+                    if (!raw)
+                        return false;
+                    if (!escaped)
+                    {
+                        out.assign(raw->data(), raw->size()); // 复用 out 已有的容量
+                        return true;
+                    }
+                    out.resize(raw->size());
+                    auto len = unescape(*raw, out.data());
+                    if (!len)
+                        return false;
+                    out.resize(*len);
+                    return true;
+                }
+                else if constexpr (std::is_same_v<T, Node>)
+                {
+                    auto value = p.parse_value();
+                    if (!value)
+                        return false;
+                    out = Node{std::move(*value)};
+                    return true;
+                }
+                else if constexpr (is_optional<T>::value)
+                {
+                    if (peek() == 'n')
+                    {
+                        out.reset();
+                        return p.parse_null().has_value();
+                    }
+                    if (!out)
+                        out.emplace();
+                    return read(*out);
+                }
+                else if constexpr (is_vector<T>::value)
+                {
+                    if (peek() != '[')
+                        return false;
+                    p.pos++;
+                    size_t n = 0; // 已有元素原地覆盖，复用其中字符串和向量的容量
+                    p.parse_whitespace();
+                    if (peek() != ']')
+                    {
+                        for (;;) // 逗号之后必须还有一个元素，不接受 [1,]
+                        {
+                            if (!read(n < out.size() ? out[n] : out.emplace_back()))
+                                return false;
+                            ++n;
+                            p.parse_whitespace();
+                            if (peek() == ']')
+                                break;
+                            if (peek() != ',')
+                                return false;
+                            p.pos++;
+                        }
+                    }
+                    p.pos++;
+                    out.resize(n);
+                    return true;
+                }
+                else
+                {
+                    static_assert(is_bound<T>::value, "type has no json_fields / bind::Fields specialization");
+                    return read_object(out);
+                }
+            }
+
+            /* 读取已绑定结构体的所有成员 */
+            template <class T>
+            auto read_object(T &out) -> bool
+            {
+                if (peek() != '{')
+                    return false;
+                p.pos++;
+                p.parse_whitespace();
+                size_t expected = 0; // 声明顺序中的下一个字段，键按声明顺序出现时一次比较即可命中
+                if (peek() == '}')
+                {
+                    p.pos++;
+                    return true;
+                }
+                for (;;) // 逗号之后必须还有一个成员，不接受 {"x":1,}
+                {
+                    p.parse_whitespace();
+                    auto key = string(scratch);
+                    if (!key)
+                        return false;
+                    p.parse_whitespace();
+                    if (peek() != ':')
+                        return false;
+                    p.pos++;
+                    p.parse_whitespace();
+                    int found = -1;
+                    if (expected < field_count<T>)
+                        found = read_field_at<T>(out, *key, expected);
+                    if (found < 0)
+                        found = read_field<T, 0>(out, *key);
+                    if (found == 0)
+                        return false;
+                    if (found < 0 && !skip()) // 未知键
+                        return false;
+                    if (found > 0)
+                        expected = size_t(found);
+                    p.parse_whitespace();
+                    if (peek() == '}')
+                        break;
+                    if (peek() != ',')
+                        return false;
+                    p.pos++;
+                }
+                p.pos++;
+                return true;
+            }
+
+            /* 函数名称: read_field
+             * 功能描述: 编译期展开的键分发：依次与第 I.. 个字段名比较，命中则读入对应成员。
+             * 返回值: 命中时为该字段下标 + 1，读取失败为 0，没有字段匹配为 -1
+             */
+            template <class T, size_t I>
+            auto read_field(T &out, std::string_view key) -> int
+            {
+                if constexpr (I == field_count<T>)
+                    return -1;
+                else
+                {
+                    const auto &f = std::get<I>(Fields<T>::value);
+                    if (key == f.name)
+                        return read(out.*(f.member)) ? int(I + 1) : 0;
+                    return read_field<T, I + 1>(out, key);
+                }
+            }
+
+            /* 只尝试第 index 个字段（运行期下标到编译期下标的一次分发） */
+            template <class T, size_t I = 0>
+            auto read_field_at(T &out, std::string_view key, size_t index) -> int
+            {
+                if constexpr (I == field_count<T>)
+                    return -1;
+                else
+                {
+                    if (index != I)
+                        return read_field_at<T, I + 1>(out, key, index);
+                    const auto &f = std::get<I>(Fields<T>::value);
+                    if (key != f.name)
+                        return -1;
+                    return read(out.*(f.member)) ? int(I + 1) : 0;
+                }
+            }
+        };
+
+        /*
+         * 函数名: parse
+         * 参数: json_str - 输入文本
+         *       out - 目标对象；vector 与 string 成员的容量会被复用
+         *       structurals - 结构索引的存储，跨多次调用复用可以避免重复分配
+         * 返回值: 成功时为 true；输入不是合法的 UTF-8、语法错误、类型不匹配或根值之后还有非空白内容时为 false
+         */
+        template <class T>
+        auto parse(std::string_view json_str, T &out, simd::StructuralIndex &structurals) -> bool
+        {
+            if (!simd::validate_utf8(json_str) || !structurals.build(json_str))
+                return false;
+            Reader r{JsonParser{json_str}};
+            r.p.index = structurals.positions.data();
+            r.p.index_size = structurals.positions.size();
+            if (!r.read(out))
+                return false;
+            return json_str.find_first_not_of(" \t\n\r", r.p.pos) == json_str.npos;
+        }
+
+        /* 单次解析的便捷入口 */
+        template <class T>
+        auto parse(std::string_view json_str) -> std::optional<T>
+        {
+            simd::StructuralIndex structurals;
+            T out{};
+            if (!parse(json_str, out, structurals))
+                return {};
+            return out;
+        }
+
+        /* 函数名称: write
+         * 功能描述: 按字段表把 value 写出到 w，字段按声明顺序输出，格式与 JsonWriter 写出 Node 时一致。
+         */
+        template <class T>
+        void write(JsonWriter &w, const T &value)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+                w.raw(value ? "true" : "false");
+            else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T> && sizeof(T) == 8)
+            {
+                char tmp[24];
+                auto r = std::to_chars(tmp, tmp + sizeof(tmp), value);
+                w.raw(std::string_view{tmp, size_t(r.ptr - tmp)});
+            }
+            else if constexpr (std::is_integral_v<T>)
+                w.write_int(Int(value));
+            else if constexpr (std::is_floating_point_v<T>)
+                w.write_float(Float(value));
+            else if constexpr (std::is_same_v<T, std::string>)
+                w.write_string(value);
+            else if constexpr (std::is_same_v<T, Node>)
+                w.write(value);
+            else if constexpr (is_optional<T>::value)
+            {
+                if (value)
+                    write(w, *value);
+                else
+                    w.raw("null");
+            }
+            else if constexpr (is_vector<T>::value)
+            {
+                w.raw("[");
+                for (size_t i = 0; i < value.size(); i++)
+                {
+                    if (i)
+                        w.raw(",");
+                    write(w, value[i]);
+                }
+                w.raw("]");
+            }
+            else
+            {
+                static_assert(is_bound<T>::value, "type has no json_fields / bind::Fields specialization");
+                w.raw("{");
+                std::apply(
+                    [&](const auto &...fields)
+                    {
+                        bool first = true;
+                        ((w.raw(first ? "" : ","), first = false, w.write_string(fields.name), w.raw(":"),
+                          write(w, value.*(fields.member))),
+                         ...);
+                    },
+                    Fields<T>::value);
+                w.raw("}");
+            }
+        }
+
+        /* 写出为 JSON 字符串 */
+        template <class T>
+        auto to_json(const T &value) -> std::string
+        {
+            std::string json_str;
+            JsonWriter w(json_str);
+            write(w, value);
+            return json_str;
+        }
+    }
+
+}
+using namespace json; // 使用 json 命名空间
+
+/*
+ * 命名空间: bench
+ * 描述: 基准测试工具。所有输入都由固定种子生成，可以离线重复运行。
+ *       通过 ./jsonparser <子命令> 调用，不带参数时保持原来的演示行为。
+ */
+namespace bench
+{
+    /* 全局 operator new 的调用次数，用于统计每次解析的堆分配 */
+    inline std::atomic<size_t> allocations{0};
+
+    /* 函数名称: make_sites
+     * 功能描述: 生成约 target_bytes 大小、以字符串为主的文档，结构同 json1.txt 中的 sites 列表。
+     */
+    inline auto make_sites(size_t target_bytes, uint32_t seed = 7) -> std::string
+    {
+        static const char *names[] = {"菜鸟教程", "google", "微博", "runoob", "github", "知乎"};
+        uint64_t state = seed;
+        std::string out = "{\n    \"sites\": [\n";
+        out.reserve(target_bytes + 256);
+        bool first = true;
+        while (out.size() < target_bytes)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            if (!first)
+                out += ", \n";
+            first = false;
+            out += "    { \"name\":\"";
+            out += names[(state >> 33) % 6];
+            out += "\" , \"url\":\"www.site" + std::to_string((state >> 20) % 100000) + ".com\" }";
+        }
+        out += "\n    ]\n}";
+        return out;
+    }
+    /* 函数名称: make_records
+     * 功能描述: 生成一个约 target_bytes 大小的 JSON 数组，元素形如 json.txt 中的人员记录。
+     */
+    inline auto make_records(size_t target_bytes, uint32_t seed = 42) -> std::string
+    {
+        static const char *names[] = {"张三", "李四", "王五", "google", "runoob", "weibo"};
+        static const char *cities[] = {"北京", "上海", "广州", "深圳"};
+        uint64_t state = seed;
+        auto next = [&]() -> uint64_t
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL; // 固定种子的 LCG
+            return state >> 33;
+        };
+        std::string out = "[";
+        out.reserve(target_bytes + 256);
+        while (out.size() < target_bytes)
+        {
+            if (out.size() > 1)
+                out += ",\n";
+            out += "  {\"name\": \"";
+            out += names[next() % 6];
+            out += "\", \"age\": " + std::to_string(next() % 100);
+            out += ", \"email\": \"user" + std::to_string(next() % 100000) + "@example.com\"";
+            out += ", \"address\": {\"city\": \"";
+            out += cities[next() % 4];
+            out += "\", \"street\": \"长安街 " + std::to_string(next() % 1000) + "\"}";
+            out += ", \"score\": " + std::to_string(next() % 1000) + "." + std::to_string(next() % 100);
+            out += ", \"active\": " + std::string(next() % 2 ? "true" : "false");
+            out += ", \"phoneNumbers\": [\"" + std::to_string(1000000000 + next() % 1000000000) + "\", \"" +
+                   std::to_string(1000000000 + next() % 1000000000) + "\"]}";
+        }
+        out += "\n]";
+        return out;
+    }
+
+    /* 函数名称: best_of
+     * 功能描述: 运行 fn 共 reps 次，返回最快一次的耗时（秒）。
+     */
+    template <class F>
+    auto best_of(int reps, F &&fn) -> double
+    {
+        double best = 1e30;
+        for (int i = 0; i < reps; i++)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            fn();
+            std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+            best = std::min(best, dt.count());
+        }
+        return best;
+    }
+
+    /* 函数名称: report
+     * 功能描述: 以 MB/s 输出一项测量结果。
+     */
+    inline void report(const std::string &label, size_t bytes, double seconds)
+    {
+        std::printf("%-28s %10.1f MB/s\n", label.c_str(), bytes / seconds / 1e6);
+    }
+
+    /* 函数名称: run_index
+     * 功能描述: 比较逐字节扫描与各结构索引内核（标量 / SSE2 / AVX2）的吞吐量。
+     */
+    inline int run_index(size_t bytes)
+    {
+        std::string doc = make_records(bytes);
+        std::printf("input: %zu bytes, best kernel: %s\n", doc.size(), simd::kernel_name(simd::best_kernel()));
+
+        report("parse (byte scan)", doc.size(), best_of(5, [&]
+                                                        { JsonParser p{doc}; p.parse().value(); }));
+
+        std::vector<simd::Kernel> kernels{simd::Kernel::Scalar};
+#ifdef JSON_HAS_X86_SIMD
+        kernels.push_back(simd::Kernel::SSE2);
+        if (simd::best_kernel() == simd::Kernel::AVX2)
+            kernels.push_back(simd::Kernel::AVX2);
+#endif
+        simd::StructuralIndex idx;
+        for (auto k : kernels)
+        {
+            std::string name = simd::kernel_name(k);
+            report("stage1 " + name, doc.size(), best_of(5, [&]
+                                                          { idx.build(doc, k); }));
+            report("stage1+parse " + name, doc.size(), best_of(5, [&]
+                                                                { 
+                idx.build(doc, k);
+                JsonParser p{doc};
+                p.index = idx.positions.data();
+                p.index_size = idx.positions.size();
+                p.parse().value(); }));
+        }
+        return 0;
+    }
+
+    /* 函数名称: make_escaped
+     * 功能描述: 生成约 bytes 字节、每个字符串都含转义（\n、\"、\\、\uXXXX 与代理对）的记录数组。
+     */
+    inline auto make_escaped(size_t bytes) -> std::string
+    {
+        std::string doc = "[";
+        for (size_t i = 0; doc.size() < bytes; i++)
+        {
+            if (i)
+                doc += ',';
+            doc += R"({"id":)" + std::to_string(i) +
+                   R"(,"text":"第 )" + std::to_string(i) + R"( 行\n\t\"quoted\" caf\u00e9 \ud83d\ude00","path":"C:\\logs\\)" +
+                   std::to_string(i % 97) + R"(.txt"})";
+        }
+        return doc + "]";
+    }
+
+    /* 函数名称: run_strings
+     * 功能描述: 字符串内核的吞吐量：各内核在长文本上的 UTF-8 校验与特殊字节查找，
+     *           以及普通记录、长文本和大量转义三种语料的 DOM 解析。
+     */
+    inline int run_strings(size_t bytes)
+    {
+        std::string records = make_records(bytes);
+        std::string escaped = make_escaped(bytes);
+        std::string prose = "[";
+        std::string line;
+        while (line.size() < 1000)
+            line += "JSON 解析器需要在线性时间内处理中英文混排的长文本, including plain ASCII runs. ";
+        while (prose.size() < bytes)
+            prose += (prose.size() > 1 ? ",\"" : "\"") + line + "\"";
+        prose += "]";
+        std::printf("input: %zu bytes each (records, long strings, escaped strings)\n", records.size());
+
+        std::vector<simd::Kernel> kernels{simd::Kernel::Scalar};
+#ifdef JSON_HAS_X86_SIMD
+        kernels.push_back(simd::Kernel::SSE2);
+        if (simd::best_kernel() == simd::Kernel::AVX2)
+            kernels.push_back(simd::Kernel::AVX2);
+#endif
+        bool ok = true;
+        size_t specials = 0;
+        for (auto k : kernels)
+        {
+            std::string name = simd::kernel_name(k);
+            if (k != simd::Kernel::SSE2) // UTF-8 校验只有标量和 AVX2 两种实现
+                report("validate_utf8 " + name, prose.size(), best_of(5, [&]
+                                                                      { ok = simd::validate_utf8(prose, k) && ok; }));
+            // 从一个特殊字节跳到下一个，与解析时定位字符串的方式相同
+            report("find_special " + name, prose.size(), best_of(5, [&]
+                                                                 {
+                specials = 0;
+                for (size_t i = 0; i < prose.size(); i++, specials++)
+                    i += simd::find_special(prose.data() + i, prose.size() - i, prose.size() - i, k); }));
+        }
+        report("parser() records", records.size(), best_of(5, [&]
+                                                           { parser(records).value(); }));
+        report("parser() long strings", prose.size(), best_of(5, [&]
+                                                               { parser(prose).value(); }));
+        report("parser() escaped strings", escaped.size(), best_of(5, [&]
+                                                                   { parser(escaped).value(); }));
+        auto decoded = parser(escaped).value();
+        ok = ok && std::get<String>(decoded[1]["text"].value) == "第 1 行\n\t\"quoted\" caf\u00e9 \U0001F600" &&
+             std::get<String>(decoded[1]["path"].value) == "C:\\logs\\1.txt";
+        std::printf("%zu special bytes; UTF-8 valid and escapes decoded correctly: %s\n", specials, ok ? "yes" : "no");
+        return ok ? 0 : 1;
+    }
+
+    /* 函数名称: run_tape
+     * 功能描述: 比较 variant 形式的 Node 与 Arena 磁带两种 DOM 的解析与遍历速度。
+     */
+    inline int run_tape(size_t bytes)
+    {
+        std::string doc = make_records(bytes);
+        std::printf("input: %zu bytes\n", doc.size());
+
+        report("parser() -> Node", doc.size(), best_of(5, [&]
+                                                       { parser(doc).value(); }));
+        tape::Document td;
+        report("tape::parse (arena reused)", doc.size(), best_of(5, [&]
+                                                                 { tape::parse(doc, td).value(); }));
+
+        // 遍历：累加所有记录的 age 字段
+        auto node = parser(doc).value();
+        auto root = tape::parse(doc, td).value();
+        Int sum_node = 0, sum_tape = 0;
+        double t_node = best_of(5, [&]
+                                { sum_node = 0; for (auto &rec : std::get<Array>(node.value)) sum_node += std::get<Int>(rec["age"].value); });
+        double t_tape = best_of(5, [&]
+                                { sum_tape = 0; for (auto rec : root) sum_tape += rec["age"].as_int(); });
+        std::printf("%-28s %10.3f ms (sum=%lld)\n", "traverse Node", t_node * 1e3, (long long)sum_node);
+        std::printf("%-28s %10.3f ms (sum=%lld)\n", "traverse tape", t_tape * 1e3, (long long)sum_tape);
+        std::printf("arena capacity: %zu bytes\n", td.arena.capacity());
+        return 0;
+    }
+
+    /* 函数名称: run_borrowed
+     * 功能描述: 在字符串为主的文档上比较拷贝模式与零拷贝借用模式的速度和每次解析的堆分配次数。
+     */
+    inline int run_borrowed(size_t bytes)
+    {
+        std::string doc = make_sites(bytes);
+        std::printf("input: %zu bytes\n", doc.size());
+
+        size_t before = allocations.load();
+        parser(doc).value();
+        size_t copy_allocs = allocations.load() - before;
+
+        tape::Arena side;
+        before = allocations.load();
+        borrowed::parse(doc, side).value();
+        size_t borrow_allocs = allocations.load() - before;
+
+        report("parser() (copying)", doc.size(), best_of(5, [&]
+                                                         { parser(doc).value(); }));
+        report("borrowed::parse", doc.size(), best_of(5, [&]
+                                                      { side.reset(); borrowed::parse(doc, side).value(); }));
+        std::printf("allocations per parse: copying %zu, borrowed %zu\n", copy_allocs, borrow_allocs);
+        return 0;
+    }
+
+    /* 函数名称: run_sax
+     * 功能描述: 只统计所有记录的 age 之和：构建完整 DOM 再遍历 与 SAX 事件流直接累加 的对比。
+     */
+    inline int run_sax(size_t bytes)
+    {
+        std::string doc = make_records(bytes);
+        std::printf("input: %zu bytes\n", doc.size());
+
+        struct AgeSum : sax::Handler
+        {
+            Int sum = 0;
+            bool is_age = false;
+            auto on_key(std::string_view key) -> bool
+            {
+                is_age = key == "age";
+                return true;
+            }
+            auto on_int(Int v) -> bool
+            {
+                if (is_age)
+                    sum += v;
+                return true;
+            }
+        };
+
+        Int dom_sum = 0;
+        report("parser() + traverse", doc.size(), best_of(5, [&]
+                                                          {
+            dom_sum = 0;
+            auto node = parser(doc).value();
+            for (auto &rec : std::get<Array>(node.value))
+                dom_sum += std::get<Int>(rec["age"].value); }));
+        AgeSum h;
+        report("sax::parse", doc.size(), best_of(5, [&]
+                                                 { h.sum = 0; sax::parse(doc, h); }));
+        h.sum = 0;
+        size_t before = allocations.load();
+        sax::parse(doc, h);
+        std::printf("sum: dom %lld, sax %lld; sax allocations per parse: %zu\n",
+                    (long long)dom_sum, (long long)h.sum, allocations.load() - before);
+        return 0;
+    }
+
+    /* 函数名称: make_ndjson
+     * 功能描述: 生成约 target_bytes 大小的 JSON Lines 文本，每行一条人员记录。
+     */
+    inline auto make_ndjson(size_t target_bytes) -> std::string
+    {
+        auto records = parser(make_records(target_bytes)).value();
+        std::string out;
+        out.reserve(target_bytes + 4096);
+        for (const auto &rec : std::get<Array>(records.value))
+        {
+            out += generate(rec);
+            out += '\n';
+        }
+        return out;
+    }
+
+    /* 函数名称: run_ndjson
+     * 功能描述: 在不同线程数下测量 NDJSON 批量解析的 documents/s 与 GB/s。
+     */
+    inline int run_ndjson(size_t bytes)
+    {
+        std::string buf = make_ndjson(bytes);
+        size_t hw = std::max(1u, std::thread::hardware_concurrency());
+        std::printf("input: %zu bytes, hardware threads: %zu\n", buf.size(), hw);
+        for (size_t threads = 1; threads <= std::max<size_t>(hw, 4); threads *= 2)
+        {
+            ThreadPool pool(threads);
+            size_t docs = 0;
+            double t = best_of(3, [&]
+                               { docs = ndjson::parse(buf, pool).size(); });
+            std::printf("threads %2zu: %12.0f docs/s %8.3f GB/s\n", threads, docs / t, buf.size() / t / 1e9);
+        }
+        return 0;
+    }
+
+    /* 函数名称: run_ndjson_file
+     * 功能描述: 解析一个 JSON Lines 文件，输出记录数和格式错误的行数。
+     */
+    inline int run_ndjson_file(const char *path)
+    {
+        MappedFile file(path);
+        if (!file)
+        {
+            std::cerr << "cannot open " << path << "\n";
+            return 1;
+        }
+        ThreadPool pool;
+        std::atomic<size_t> docs{0}, failed{0};
+        ndjson::for_each(file.data(), pool, [&](size_t, std::optional<Node> doc)
+                         { ++docs; failed += !doc; });
+        std::printf("%zu documents, %zu failed\n", docs.load(), failed.load());
+        return failed ? 1 : 0;
+    }
+
+    /* 函数名称: reset_peak_rss
+     * 功能描述: 把本进程的峰值 RSS 重置为当前 RSS（Linux 的 /proc/self/clear_refs），
+     *           否则 fork 出的子进程会继承父进程的峰值。其他平台上什么也不做。
+     */
+    inline void reset_peak_rss()
+    {
+        if (FILE *f = std::fopen("/proc/self/clear_refs", "w"))
+        {
+            std::fputs("5", f);
+            std::fclose(f);
+        }
+    }
+
+    /* 函数名称: in_child
+     * 功能描述: 在子进程中运行 fn 并输出其耗时与峰值 RSS，使各项测量的峰值互不影响。
+     */
+    template <class F>
+    void in_child(const char *label, size_t bytes, F &&fn)
+    {
+#ifdef JSON_HAS_MMAP
+        std::fflush(stdout);
+        pid_t pid = ::fork();
+        if (pid == 0)
+        {
+            reset_peak_rss();
+            auto t0 = std::chrono::steady_clock::now();
+            fn();
+            std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+            struct rusage ru;
+            ::getrusage(RUSAGE_SELF, &ru);
+            std::printf("%-28s %10.1f MB/s  peak RSS %8ld KB\n", label, bytes / dt.count() / 1e6, long(ru.ru_maxrss));
+            std::fflush(stdout);
+            ::_exit(0);
+        }
+        int status;
+        ::waitpid(pid, &status, 0);
+#else
+        report(label, bytes, best_of(1, fn));
+#endif
+    }
+
+    /* 函数名称: run_mmap
+     * 功能描述: 比较 ifstream -> stringstream -> std::string 读入与 mmap 直接解析的耗时和峰值 RSS。
+     */
+    inline int run_mmap(size_t bytes)
+    {
+        std::string path = "/tmp/jsonparser_bench_mmap.json";
+        std::printf("input: %s (%zu bytes)\n", path.c_str(), bytes);
+        // 语料也在子进程中生成，父进程的峰值 RSS 不会被后续子进程继承
+        in_child("write corpus", bytes, [&]
+                 { std::ofstream(path, std::ios::binary) << make_records(bytes); });
+        auto read_copy = [&]
+        {
+            std::ifstream fin(path);
+            std::stringstream ss;
+            ss << fin.rdbuf();
+            return std::string{ss.str()};
+        };
+        in_child("load+index (ifstream)", bytes, [&]
+                 { std::string s = read_copy(); simd::StructuralIndex idx; idx.build(s); });
+        in_child("load+index (mmap)", bytes, [&]
+                 { MappedFile f(path); simd::StructuralIndex idx; idx.build(f.data()); });
+        in_child("parse (ifstream)", bytes, [&]
+                 { std::string s = read_copy(); parser(s).value(); });
+        in_child("parse_file (mmap)", bytes, [&]
+                 { parse_file(path).value(); });
+        std::remove(path.c_str());
+        return 0;
+    }
+
+    /* 函数名称: run_binary
+     * 功能描述: 模拟进程重启：每个场景在新的子进程中从文件加载同一份快照，比较解析文本与映射二进制文件的耗时，
+     *           并检查 文本 -> Node -> 二进制 -> Node -> 文本 的往返没有损失。吞吐量均按文本大小计算。
+     */
+    inline int run_binary(size_t bytes)
+    {
+        std::string text_path = "/tmp/jsonparser_bench_snapshot.json";
+        std::string binary_path = "/tmp/jsonparser_bench_snapshot.bin";
+        // 语料、编码和无损校验都在子进程中完成，父进程的峰值 RSS 不会被后续子进程继承
+        in_child("write corpus", bytes, [&]
+                 {
+            std::string text = make_records(bytes);
+            auto doc = parser(text).value();
+            std::string encoded;
+            report("BinaryGenerator::generate", text.size(), best_of(3, [&]
+                                                                       { encoded = BinaryGenerator::generate(doc); }));
+            std::ofstream(text_path, std::ios::binary) << text;
+            std::ofstream(binary_path, std::ios::binary) << encoded;
+            binary::File file{std::string_view{encoded}};
+            auto root = file.root().value();
+            std::printf("text %zu bytes, binary %zu bytes, round trip lossless: %s\n", text.size(), encoded.size(),
+                        generate(root.to_node()) == generate(doc) ? "yes" : "no"); });
+
+        binary::File snapshot(binary_path);
+        auto snapshot_root = snapshot.root();
+        if (!snapshot_root)
+        {
+            std::cerr << "cannot read " << binary_path << "\n";
+            return 1;
+        }
+        size_t n = snapshot_root->size();
+        in_child("text: parse_file + lookup", bytes, [&]
+                 {
+            auto d = parse_file(text_path).value();
+            std::printf("%s ", generate(d[n - 1]["address"]["city"]).c_str()); });
+        in_child("binary: open + lookup", bytes, [&]
+                 {
+            binary::File f(binary_path);
+            auto root = f.root().value();
+            std::printf("\"%s\" ", std::string(root[n - 1]["address"]["city"].get_string()).c_str()); });
+        in_child("binary: open + walk all", bytes, [&]
+                 {
+            binary::File f(binary_path);
+            auto root = f.root().value();
+            Int sum = 0;
+            for (auto record : root)
+                sum += record["age"].get_int();
+            std::printf("%lld ", (long long)sum); });
+        in_child("binary: open + to_node", bytes, [&]
+                 {
+            binary::File f(binary_path);
+            f.root().value().to_node(); });
+        std::remove(text_path.c_str());
+        std::remove(binary_path.c_str());
+        return 0;
+    }
+
+    /* 函数名称: make_numbers
+     * 功能描述: 生成约 target_bytes 大小、以数字为主的文档：地理坐标点与整数指标。
+     */
+    inline auto make_numbers(size_t target_bytes, uint32_t seed = 11) -> std::string
+    {
+        uint64_t state = seed;
+        auto next = [&]() -> uint64_t
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return state >> 11;
+        };
+        std::string out = "[";
+        out.reserve(target_bytes + 128);
+        char buf[96];
+        while (out.size() < target_bytes)
+        {
+            double lon = (next() % 3600000000ULL) / 1e7 - 180.0;
+            double lat = (next() % 1800000000ULL) / 1e7 - 90.0;
+            std::snprintf(buf, sizeof(buf), "%s[%.7f,%.7f,%llu,%.15g]", out.size() > 1 ? "," : "", lon, lat,
+                          (unsigned long long)(next() % 10000000), (next() % 1000000) * 1.0e-3);
+            out += buf;
+        }
+        out += "]";
+        return out;
+    }
+
+    /* 函数名称: run_numbers
+     * 功能描述: 比较旧的 临时 std::string + stod/stoi、std::from_chars 与 number::parse 内核的逐个数字吞吐量，
+     *           以及整篇数字文档的解析速度。
+     */
+    inline int run_numbers(size_t bytes)
+    {
+        std::string doc = make_numbers(bytes);
+        std::vector<std::string_view> tokens;
+        for (size_t i = 0; i < doc.size();)
+        {
+            size_t j = doc.find_first_of(",[]", i);
+            if (j > i)
+                tokens.push_back(std::string_view{doc}.substr(i, j - i));
+            if (j == doc.npos)
+                break;
+            i = j + 1;
+        }
+        size_t token_bytes = 0;
+        for (auto t : tokens)
+            token_bytes += t.size();
+        std::printf("input: %zu bytes, %zu numbers\n", doc.size(), tokens.size());
+
+        double sink = 0;
+        report("stod/stoi (temp string)", token_bytes, best_of(3, [&]
+                                                                {
+            for (auto t : tokens)
+            {
+                std::string s{t};
+                sink += s.find_first_of(".eE") != s.npos ? std::stod(s) : double(std::stoll(s));
+            } }));
+        report("std::from_chars", token_bytes, best_of(3, [&]
+                                                       {
+            for (auto t : tokens)
+            {
+                double d;
+                std::from_chars(t.data(), t.data() + t.size(), d);
+                sink += d;
+            } }));
+        report("number::parse", token_bytes, best_of(3, [&]
+                                                      {
+            for (auto t : tokens)
+            {
+                auto r = number::parse(t.data(), t.data() + t.size());
+                sink += r.kind == number::Kind::Int ? double(r.i) : r.f;
+            } }));
+        report("parser() numeric doc", doc.size(), best_of(3, [&]
+                                                           { parser(doc).value(); }));
+        tape::Document td;
+        report("tape::parse numeric doc", doc.size(), best_of(3, [&]
+                                                              { tape::parse(doc, td).value(); }));
+        return sink == 0.5 ? 2 : 0; // 使用 sink，防止被优化掉
+    }
+
+    /* 函数名称: legacy_generate
+     * 功能描述: 旧版 JsonGenerator 的实现（每层递归返回一个新字符串、std::to_string 格式化浮点数），仅用于对比。
+     */
+    inline auto legacy_generate(const Node &node) -> std::string
+    {
+        return std::visit(
+            [](auto &&arg) -> std::string
+            {
+                using T = std::decay_t<decltype(arg)>;
+                if constexpr (std::is_same_v<T, Null>)
+                    return "null";
+                else if constexpr (std::is_same_v<T, Bool>)
+                    return arg ? "true" : "false";
+                else if constexpr (std::is_same_v<T, Int> || std::is_same_v<T, Float>)
+                    return std::to_string(arg);
+                else if constexpr (std::is_same_v<T, String>)
+                    return "\"" + arg + "\"";
+                else if constexpr (std::is_same_v<T, Array>)
+                {
+                    std::string json_str = "[";
+                    for (const auto &node : arg)
+                        json_str += legacy_generate(node) + ",";
+                    if (!arg.empty())
+                        json_str.pop_back();
+                    return json_str + "]";
+                }
+                else
+                {
+                    std::string json_str = "{";
+                    for (const auto &[key, node] : arg)
+                        json_str += "\"" + key.str() + "\":" + legacy_generate(node) + ",";
+                    if (!arg.empty())
+                        json_str.pop_back();
+                    return json_str + "}";
+                }
+            },
+            node.value);
+    }
+
+    /* 函数名称: run_generate
+     * 功能描述: 比较旧的递归拼接生成器与单遍 JsonWriter（字符串、ostream、文件描述符三种目标）的序列化吞吐量。
+     */
+    inline int run_generate(size_t bytes)
+    {
+        auto records = parser(make_records(bytes)).value();
+        auto numbers = parser(make_numbers(bytes)).value();
+        for (auto *doc : {&records, &numbers})
+        {
+            size_t out_bytes = generate(*doc).size();
+            std::printf("%s document, %zu bytes of output\n", doc == &records ? "records" : "numeric", out_bytes);
+            report("legacy generator", out_bytes, best_of(3, [&]
+                                                          { legacy_generate(*doc); }));
+            report("JsonGenerator::generate", out_bytes, best_of(3, [&]
+                                                                 { generate(*doc); }));
+            std::ostringstream os;
+            report("JsonWriter -> ostream", out_bytes, best_of(3, [&]
+                                                               { os.str(""); JsonWriter(os).write(*doc); }));
+#ifdef JSON_HAS_POSIX
+            int fd = ::open("/dev/null", O_WRONLY);
+            report("JsonWriter -> fd", out_bytes, best_of(3, [&]
+                                                          { JsonWriter(fd).write(*doc); }));
+            ::close(fd);
+#endif
+        }
+
+        // 并行生成：输出必须与顺序生成逐字节相同
+        std::string expected = generate(records);
+        size_t hw = std::max(1u, std::thread::hardware_concurrency());
+        bool identical = true;
+        for (size_t threads = 1; threads <= std::max<size_t>(hw, 4); threads *= 2)
+        {
+            ThreadPool pool(threads);
+            ParallelGenerator gen(pool);
+            identical = identical && gen.generate(records) == expected;
+            char label[48];
+            std::snprintf(label, sizeof(label), "parallel, %zu threads", threads);
+            report(label, expected.size(), best_of(3, [&]
+                                                   { gen.generate(records); }));
+#ifdef JSON_HAS_POSIX
+            int fd = ::open("/dev/null", O_WRONLY);
+            std::snprintf(label, sizeof(label), "parallel writev, %zu threads", threads);
+            report(label, expected.size(), best_of(3, [&]
+                                                   { gen.write(fd, records); }));
+            ::close(fd);
+#endif
+        }
+        std::printf("parallel output identical: %s (hardware threads: %zu)\n", identical ? "yes" : "no", hw);
+
+        // 缓存模式：每轮修改一个记录的字段后重新生成，只有被修改的路径需要重新写出（未启用 JSON_NODE_CACHE 时等同 generate）
+        std::printf("node cache: %s, sizeof(Node) %zu\n", JSON_NODE_CACHE ? "on" : "off", sizeof(Node));
+        report("generate_cached (cold)", expected.size(), best_of(1, [&]
+                                                                  { JsonGenerator::generate_cached(records); }));
+        size_t n = std::get<Array>(records.value).size(), edits = 0;
+        std::string cached;
+        report("edit + generate_cached", expected.size(), best_of(3, [&]
+                                                                 {
+            edits++;
+            records[edits * 7919 % n]["age"] = Node{Int(edits % 100)};
+            cached = JsonGenerator::generate_cached(records); }));
+        bool cache_identical = cached == generate(records);
+        std::printf("cached output identical: %s\n", cache_identical ? "yes" : "no");
+
+        bool errors_reported = true;
+#ifdef JSON_HAS_POSIX
+        // 写入 /dev/full 总是失败（ENOSPC），两种写出方式都必须报告出来
+        int full = ::open("/dev/full", O_WRONLY);
+        if (full >= 0)
+        {
+            JsonWriter w(full, 4096);
+            w.write(records);
+            errors_reported = !w.flush() && !w.good();
+            ThreadPool pool(2);
+            errors_reported = errors_reported && !ParallelGenerator(pool).write(full, records);
+            ::close(full);
+            std::printf("write errors reported: %s\n", errors_reported ? "yes" : "no");
+        }
+#endif
+        return identical && cache_identical && errors_reported ? 0 : 1;
+    }
+
+    /* 函数名称: run_push
+     * 功能描述: 以不同块大小把文档分块送入推送式解析器，与一次性的 sax::parse 比较吞吐量。
+     */
+    inline int run_push(size_t bytes)
+    {
+        std::string doc = make_records(bytes);
+        std::printf("input: %zu bytes\n", doc.size());
+        struct Counter : sax::Handler
+        {
+            size_t strings = 0;
+            auto on_string(std::string_view) -> bool
+            {
+                ++strings;
+                return true;
+            }
+        };
+        Counter c;
+        report("sax::parse (whole buffer)", doc.size(), best_of(3, [&]
+                                                                { sax::parse(doc, c); }));
+        for (size_t chunk : {size_t{512}, size_t{4096}, size_t{65536}})
+        {
+            report("push events, chunk " + std::to_string(chunk), doc.size(), best_of(3, [&]
+                                                                                       {
+                push::Parser<Counter> pp(c);
+                for (size_t i = 0; i < doc.size(); i += chunk)
+                    pp.feed(std::string_view{doc}.substr(i, chunk));
+                pp.finish(); }));
+        }
+        report("push DOM, chunk 65536", doc.size(), best_of(3, [&]
+                                                            {
+            sax::DomBuilder b([](Node &&) { return true; });
+            push::Parser<sax::DomBuilder> pp(b);
+            for (size_t i = 0; i < doc.size(); i += 65536)
+                pp.feed(std::string_view{doc}.substr(i, 65536));
+            pp.finish(); }));
+        return 0;
+    }
+
+    /* 函数名称: run_push_stdin
+     * 功能描述: 从标准输入按块读取（管道、解压输出等），每个顶层值一闭合就立即输出，不必先读完全部数据。
+     */
+    inline int run_push_stdin()
+    {
+        size_t docs = 0;
+        sax::DomBuilder b([&](Node &&doc)
+                          { std::cout << doc << "\n"; ++docs; return true; });
+        push::Parser<sax::DomBuilder> pp(b);
+        std::vector<char> chunk(64 << 10);
+        auto status = push::Status::NeedMore;
+        while (status == push::Status::NeedMore && std::cin)
+        {
+            std::cin.read(chunk.data(), std::streamsize(chunk.size()));
+            status = pp.feed(std::string_view{chunk.data(), size_t(std::cin.gcount())});
+        }
+        status = pp.finish();
+        std::cerr << docs << " documents\n";
+        return status == push::Status::Done ? 0 : 1;
+    }
+
+    /* 函数名称: run_ondemand
+     * 功能描述: 只取每条记录的 age 和 address.city 时，比较完整 DOM 解析与按需访问；
+     *           再测一次只取最后一条记录（其余记录全部被跳过）的情况。
+     */
+    inline int run_ondemand(size_t bytes)
+    {
+        std::string doc = make_records(bytes);
+        std::printf("input: %zu bytes\n", doc.size());
+
+        int64_t dom_sum = 0, od_sum = 0;
+        size_t dom_city = 0, od_city = 0;
+        report("dom: age + city", doc.size(), best_of(5, [&]
+                                                      {
+            auto root = parser(doc).value();
+            dom_sum = 0, dom_city = 0;
+            for (const auto &rec : std::get<Array>(root.value))
+            {
+                auto &obj = std::get<Object>(rec.value);
+                dom_sum += std::get<Int>(obj.at("age").value);
+                dom_city += std::get<String>(std::get<Object>(obj.at("address").value).at("city").value) == "北京";
+            } }));
+
+        ondemand::Document od;
+        report("ondemand: age + city", doc.size(), best_of(5, [&]
+                                                           {
+            auto root = ondemand::parse(doc, od).value();
+            od_sum = 0, od_city = 0;
+            for (auto rec : root)
+            {
+                od_sum += rec["age"].get_int();
+                od_city += rec["address"]["city"].get_string() == "北京";
+            } }));
+
+        std::string last;
+        report("ondemand: last city only", doc.size(), best_of(5, [&]
+                                                               {
+            auto root = ondemand::parse(doc, od).value();
+            auto it = root.begin(), prev = it;
+            for (; it != root.end(); ++it)
+                prev = it;
+            last = (*prev)["address"]["city"].get_string(); }));
+
+        std::printf("age sum: dom %lld, ondemand %lld; 北京: dom %zu, ondemand %zu; last city %s\n",
+                    (long long)dom_sum, (long long)od_sum, dom_city, od_city, last.c_str());
+        return dom_sum == od_sum && dom_city == od_city ? 0 : 1;
+    }
+
+    /* 函数名称: run_path
+     * 功能描述: 对每行 NDJSON 记录求一组预编译路径：先完整解析再对 Node 求值，与直接对原始文本求值比较。
+     */
+    inline int run_path(size_t bytes)
+    {
+        std::string buf = make_ndjson(bytes);
+        std::vector<std::string_view> lines;
+        ndjson::for_each_line(buf, [&](std::string_view line, size_t)
+                              { lines.push_back(line); });
+        std::vector<Path> paths;
+        for (const char *expr : {"/address/city", "/phoneNumbers/1", "$.age", "$.phoneNumbers[*]", "$['email']"})
+            paths.push_back(Path::compile(expr).value());
+        std::printf("input: %zu bytes, %zu documents, %zu paths\n", buf.size(), lines.size(), paths.size());
+
+        size_t dom_hits = 0, raw_hits = 0;
+        double t = best_of(3, [&]
+                           {
+            dom_hits = 0;
+            for (auto line : lines)
+            {
+                auto root = parser(line).value();
+                for (const auto &path : paths)
+                    dom_hits += path.evaluate(root).size();
+            } });
+        std::printf("%-28s %12.0f docs/s\n", "parse + Path on Node", lines.size() / t);
+
+        ondemand::Document doc;
+        t = best_of(3, [&]
+                    {
+            raw_hits = 0;
+            for (auto line : lines)
+            {
+                auto root = ondemand::parse(line, doc).value(); // 同一文档上的多条路径共用一次索引
+                for (const auto &path : paths)
+                    raw_hits += path.evaluate(root).size();
+            } });
+        std::printf("%-28s %12.0f docs/s\n", "Path on raw text", lines.size() / t);
+
+        std::printf("matches: node %zu, raw %zu\n", dom_hits, raw_hits);
+        return dom_hits == raw_hits ? 0 : 1;
+    }
+
+    /* 函数名称: run_intern
+     * 功能描述: NDJSON 批量解析时比较不用键池与共享键池的 docs/s 和每文档分配次数，
+     *           并比较普通键与驻留键的对象查找速度。
+     */
+    inline int run_intern(size_t bytes)
+    {
+        std::string buf = make_ndjson(bytes);
+        ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+        KeyPool keys;
+        size_t docs = 0;
+        for (KeyPool *k : {static_cast<KeyPool *>(nullptr), &keys})
+        {
+            ndjson::Options options;
+            options.keys = k;
+            double t = best_of(3, [&]
+                               { docs = ndjson::parse(buf, pool, options).size(); });
+            size_t before = allocations.load();
+            ndjson::parse(buf, pool, options);
+            std::printf("%-20s %12.0f docs/s %8.1f allocations/doc\n", k ? "shared key pool" : "no key pool",
+                        docs / t, double(allocations.load() - before) / docs);
+        }
+        auto stats = keys.stats();
+        std::printf("pool: %zu keys, %zu hits, %zu misses\n", stats.size, stats.hits, stats.misses);
+
+        std::vector<std::string_view> lines;
+        ndjson::for_each_line(buf, [&](std::string_view line, size_t)
+                              { lines.push_back(line); });
+        simd::StructuralIndex index;
+        std::vector<Node> plain, interned;
+        for (auto line : lines)
+        {
+            plain.push_back(parser(line, index).value());
+            interned.push_back(parser(line, index, &keys).value());
+        }
+        const InternedKey *phone = keys.find("phoneNumbers");
+        size_t hits = 0;
+        double by_string = best_of(3, [&]
+                                   { for (const auto &n : plain) hits += std::get<Object>(n.value).count("phoneNumbers"); });
+        double by_handle = best_of(3, [&]
+                                   { for (const auto &n : interned) hits += std::get<Object>(n.value).count(Key{phone}); });
+        std::printf("%-20s %12.0f lookups/s\n%-20s %12.0f lookups/s\n", "lookup by string", lines.size() / by_string,
+                    "lookup by handle", lines.size() / by_handle);
+        return hits ? 0 : 1;
+    }
+
+    /* 函数名称: walk
+     * 功能描述: 遍历整棵树，累加整数与字符串长度，用于比较两种 DOM 的遍历速度。
+     */
+    inline auto walk(const Node &node) -> int64_t
+    {
+        if (auto *i = std::get_if<Int>(&node.value))
+            return *i;
+        if (auto *str = std::get_if<String>(&node.value))
+            return int64_t(str->size());
+        int64_t sum = 0;
+        if (auto *arr = std::get_if<Array>(&node.value))
+            for (const auto &v : *arr)
+                sum += walk(v);
+        else if (auto *obj = std::get_if<Object>(&node.value))
+            for (const auto &[k, v] : *obj)
+                sum += walk(v);
+        return sum;
+    }
+    inline auto walk(const compact::Node &node) -> int64_t
+    {
+        return node.visit(
+            [](auto &&arg) -> int64_t
+            {
+                using T = std::decay_t<decltype(arg)>;
+                int64_t sum = 0;
+                if constexpr (std::is_same_v<T, Int>)
+                    sum = arg;
+                else if constexpr (std::is_same_v<T, std::string_view>)
+                    sum = int64_t(arg.size());
+                else if constexpr (std::is_same_v<T, compact::Array>)
+                    for (const auto &v : arg)
+                        sum += walk(v);
+                else if constexpr (std::is_same_v<T, compact::Object>)
+                    for (const auto &[k, v] : arg)
+                        sum += walk(v);
+                return sum;
+            });
+    }
+
+    /* 函数名称: run_compact
+     * 功能描述: 比较 variant 形式的 json::Node 与 16 字节 compact::Node 的解析速度、分配次数、峰值 RSS 和遍历速度。
+     */
+    inline int run_compact(size_t bytes)
+    {
+        std::string doc = make_records(bytes);
+        std::printf("input: %zu bytes, sizeof(json::Node) %zu, sizeof(compact::Node) %zu\n", doc.size(), sizeof(Node),
+                    sizeof(compact::Node));
+
+        // 峰值 RSS：各自在子进程中解析并持有整棵树（放在父进程建树之前，避免继承父进程的峰值）
+        in_child("tree in child (Node)", doc.size(), [&]
+                 { parser(doc).value(); });
+        in_child("tree in child (compact)", doc.size(), [&]
+                 { compact::parse(doc).value(); });
+
+        simd::StructuralIndex index;
+        report("parser() -> Node", doc.size(), best_of(3, [&]
+                                                       { parser(doc, index).value(); }));
+        report("compact::parse", doc.size(), best_of(3, [&]
+                                                     { compact::parse(doc, index).value(); }));
+
+        size_t before = allocations.load();
+        auto node = parser(doc, index).value();
+        size_t node_allocs = allocations.load() - before;
+        before = allocations.load();
+        auto cnode = compact::parse(doc, index).value();
+        size_t compact_allocs = allocations.load() - before;
+        std::printf("allocations per parse: Node %zu, compact %zu\n", node_allocs, compact_allocs);
+
+        int64_t sum_node = 0, sum_compact = 0;
+        double t_node = best_of(5, [&]
+                                { sum_node = walk(node); });
+        double t_compact = best_of(5, [&]
+                                   { sum_compact = walk(cnode); });
+        std::printf("%-28s %10.3f ms (sum=%lld)\n", "traverse Node", t_node * 1e3, (long long)sum_node);
+        std::printf("%-28s %10.3f ms (sum=%lld)\n", "traverse compact", t_compact * 1e3, (long long)sum_compact);
+        bool same = generate(node) == generate(cnode);
+        std::printf("generate() identical: %s\n", same ? "yes" : "no");
+        return same && sum_node == sum_compact ? 0 : 1;
+    }
+
+    /*
+     * 结构体: Address / Person
+     * 描述: 与 make_records 生成的记录（以及 json.txt 中的人员记录）对应的类型化结构，用于 bench-bind。
      */
-    auto operator<<(std::ostream &out, const Node &t) -> std::ostream &
+    struct Address
+    {
+        std::string city;
+        std::string street;
+        static constexpr auto json_fields = std::make_tuple(bind::field("city", &Address::city),
+                                                            bind::field("street", &Address::street));
+    };
+    struct Person
+    {
+        std::string name;
+        int age = 0;
+        std::string email;
+        Address address;
+        double score = 0;
+        bool active = false;
+        std::vector<std::string> phoneNumbers;
+        static constexpr auto json_fields = std::make_tuple(
+            bind::field("name", &Person::name), bind::field("age", &Person::age), bind::field("email", &Person::email),
+            bind::field("address", &Person::address), bind::field("score", &Person::score),
+            bind::field("active", &Person::active), bind::field("phoneNumbers", &Person::phoneNumbers));
+    };
+
+    /* 函数名称: to_person
+     * 功能描述: 先解析成 Node 再手工转换的常见做法，作为 bench-bind 的对照组。
+     */
+    inline auto to_person(const Node &node) -> Person
+    {
+        const auto &obj = std::get<Object>(node.value);
+        const auto &addr = std::get<Object>(obj.at("address").value);
+        Person p;
+        p.name = std::get<String>(obj.at("name").value);
+        p.age = int(std::get<Int>(obj.at("age").value));
+        p.email = std::get<String>(obj.at("email").value);
+        p.address.city = std::get<String>(addr.at("city").value);
+        p.address.street = std::get<String>(addr.at("street").value);
+        p.score = std::get<Float>(obj.at("score").value);
+        p.active = std::get<Bool>(obj.at("active").value);
+        for (const auto &phone : std::get<Array>(obj.at("phoneNumbers").value))
+            p.phoneNumbers.push_back(std::get<String>(phone.value));
+        return p;
+    }
+
+    /* 函数名称: run_bind
+     * 功能描述: 比较 memcpy、parser() + 手工转换与 bind::parse 直接写入结构体的吞吐量，以及两种写出方式。
+     */
+    inline int run_bind(size_t bytes)
+    {
+        std::string doc = make_records(bytes);
+        std::printf("input: %zu bytes\n", doc.size());
+
+        std::string copy(doc.size(), '\0');
+        report("memcpy", doc.size(), best_of(5, [&]
+                                             { std::memcpy(copy.data(), doc.data(), doc.size()); }));
+
+        simd::StructuralIndex index;
+        std::vector<Person> via_node;
+        report("parser() + to_person", doc.size(), best_of(3, [&]
+                                                           {
+            via_node.clear();
+            auto root = parser(doc, index).value();
+            for (const auto &rec : std::get<Array>(root.value))
+                via_node.push_back(to_person(rec)); }));
+
+        std::vector<Person> people;
+        report("bind::parse", doc.size(), best_of(5, [&]
+                                                  { bind::parse(doc, people, index); }));
+
+        std::string out;
+        report("bind::to_json", doc.size(), best_of(5, [&]
+                                                    { out = bind::to_json(people); }));
+        auto node = parser(doc, index).value();
+        report("generate(Node)", doc.size(), best_of(5, [&]
+                                                     { generate(node); }));
+
+        bool same = out == generate(node) && people.size() == via_node.size();
+        std::printf("records: %zu, to_json identical to generate(Node): %s\n", people.size(), same ? "yes" : "no");
+        return same ? 0 : 1;
+    }
+
+    /*
+     * 结构体: Lcg
+     * 描述: 固定种子的线性同余发生器，语料生成专用，保证离线可复现。
+     */
+    struct Lcg
+    {
+        uint64_t state;
+        auto next() -> uint64_t
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return state >> 33;
+        }
+        auto pick(size_t n) -> size_t { return size_t(next() % n); }
+    };
+
+    /* 函数名称: make_twitter
+     * 功能描述: 仿 twitter.json：多语种推文文本（含 \n、\" 与 \/ 转义）、嵌套的 user/entities 对象、大整数 id。
+     */
+    inline auto make_twitter(size_t target_bytes, uint32_t seed) -> std::string
+    {
+        static const char *texts[] = {"@aym0566x \\n\\n名前:前田あゆみ\\n第一印象:なんか怖っ！", "RT @KATANA77: えっそれは・・・（一同） http:\\/\\/t.co\\/PkCJAcSuYK",
+                                      "今天天气不错 \\\"出去走走\\\" #周末", "Just setting up my twttr 🐦", "【映画パンフレット】　永遠の0 (永遠のゼロ)　監督　山崎貴",
+                                      "@suzuki_a 朝から晩まで一緒にいたいね。\\u2661"};
+        static const char *names[] = {"AYUMI", "なぎ", "张伟", "Jack", "Ｓｙｕｎ", "🍣 sushi"};
+        static const char *langs[] = {"ja", "zh", "en"};
+        Lcg rng{seed};
+        std::string out = "{\"statuses\":[";
+        out.reserve(target_bytes + 4096);
+        for (size_t i = 0; out.size() < target_bytes; i++)
+        {
+            std::string id = std::to_string(505874924095815681ULL + rng.next());
+            std::string uid = std::to_string(1186275104 + rng.next() % 100000000);
+            if (i)
+                out += ',';
+            out += "{\"metadata\":{\"result_type\":\"recent\",\"iso_language_code\":\"";
+            out += langs[rng.pick(3)];
+            out += "\"},\"created_at\":\"Sun Aug 31 00:29:15 +0000 2014\",\"id\":" + id + ",\"id_str\":\"" + id + "\",\"text\":\"";
+            out += texts[rng.pick(6)];
+            out += "\",\"source\":\"<a href=\\\"http:\\/\\/twitter.com\\/download\\/iphone\\\" rel=\\\"nofollow\\\">Twitter for iPhone<\\/a>\"";
+            out += ",\"truncated\":false,\"in_reply_to_status_id\":null,\"user\":{\"id\":" + uid + ",\"id_str\":\"" + uid + "\",\"name\":\"";
+            out += names[rng.pick(6)];
+            out += "\",\"screen_name\":\"user" + std::to_string(rng.pick(100000)) + "\",\"location\":\"東京\",\"description\":\"";
+            out += texts[rng.pick(6)];
+            out += "\",\"url\":null,\"followers_count\":" + std::to_string(rng.pick(100000)) +
+                   ",\"friends_count\":" + std::to_string(rng.pick(5000)) +
+                   ",\"verified\":false,\"profile_image_url\":\"http:\\/\\/pbs.twimg.com\\/profile_images\\/" + uid + "\\/normal.jpeg\"}";
+            out += ",\"geo\":null,\"coordinates\":null,\"retweet_count\":" + std::to_string(rng.pick(1000)) +
+                   ",\"favorite_count\":" + std::to_string(rng.pick(1000));
+            out += ",\"entities\":{\"hashtags\":[{\"text\":\"周末\",\"indices\":[10,13]}],\"urls\":[],\"user_mentions\":[{\"screen_name\":\"aym0566x\",\"name\":\"前田あゆみ\",\"id\":" +
+                   uid + ",\"id_str\":\"" + uid + "\",\"indices\":[0,9]}]},\"favorited\":false,\"retweeted\":false,\"lang\":\"ja\"}";
+        }
+        out += "],\"search_metadata\":{\"completed_in\":0.087,\"max_id\":505874924095815681,\"query\":\"%E4%B8%80\",\"count\":100}}";
+        return out;
+    }
+
+    /* 函数名称: make_canada
+     * 功能描述: 仿 canada.json：一个 GeoJSON 多边形，几乎全部是 15~17 位有效数字的浮点坐标对。
+     */
+    inline auto make_canada(size_t target_bytes, uint32_t seed) -> std::string
+    {
+        Lcg rng{seed};
+        std::string out = "{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\",\"properties\":{\"name\":\"Canada\"},"
+                          "\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[";
+        out.reserve(target_bytes + 256);
+        char buf[64];
+        for (size_t ring = 0; out.size() < target_bytes; ring++)
+        {
+            out += ring ? ",[" : "[";
+            double x = -141.0 + rng.pick(8000000) * 1e-5, y = 42.0 + rng.pick(4000000) * 1e-5;
+            for (int i = 0; i < 512; i++)
+            {
+                x += (double(rng.pick(2000001)) - 1e6) * 1e-9;
+                y += (double(rng.pick(2000001)) - 1e6) * 1e-9;
+                std::snprintf(buf, sizeof(buf), "%s[%.17g,%.17g]", i ? "," : "", x, y);
+                out += buf;
+            }
+            out += ']';
+        }
+        out += "]}}]}";
+        return out;
+    }
+
+    /* 函数名称: make_citm
+     * 功能描述: 仿 citm_catalog.json：以数字 id 为键的大对象、大量小对象和整数数组、null 较多。
+     */
+    inline auto make_citm(size_t target_bytes, uint32_t seed) -> std::string
+    {
+        static const char *areas[] = {"Arrière-scène central", "1er balcon central", "2ème balcon bergerie cour", "Baignoire", "Parterre", "Loge"};
+        Lcg rng{seed};
+        std::string out = "{\"areaNames\":{";
+        out.reserve(target_bytes + 4096);
+        for (int i = 0; i < 6; i++)
+            out += std::string(i ? "," : "") + "\"" + std::to_string(205705993 + i) + "\":\"" + areas[i] + "\"";
+        out += "},\"audienceSubCategoryNames\":{\"337100890\":\"Abonné\"},\"blockNames\":{},\"events\":{";
+        std::vector<std::string> events;
+        for (int i = 0; i < 64; i++)
+        {
+            std::string id = std::to_string(138586341 + i * 16);
+            events.push_back(id);
+            out += std::string(i ? "," : "") + "\"" + id + "\":{\"description\":null,\"id\":" + id +
+                   ",\"logo\":null,\"name\":\"30th Anniversary Tour\",\"subTopicIds\":[337184269,337184283],"
+                   "\"subjectCode\":null,\"subtitle\":null,\"topicIds\":[324846099,107888604]}";
+        }
+        out += "},\"performances\":[";
+        for (size_t i = 0; out.size() < target_bytes; i++)
+        {
+            out += i ? "," : "";
+            out += "{\"eventId\":" + events[rng.pick(events.size())] + ",\"id\":" + std::to_string(339887544 + i) +
+                   ",\"logo\":null,\"name\":null,\"prices\":[";
+            size_t prices = 1 + rng.pick(4);
+            for (size_t p = 0; p < prices; p++)
+                out += std::string(p ? "," : "") + "{\"amount\":" + std::to_string(9000 + rng.pick(90000)) +
+                       ",\"audienceSubCategoryId\":337100890,\"seatCategoryId\":" + std::to_string(338937295 + p) + "}";
+            out += "],\"seatCategories\":[";
+            for (size_t p = 0; p < prices; p++)
+                out += std::string(p ? "," : "") + "{\"areas\":[{\"areaId\":" + std::to_string(205705993 + rng.pick(6)) +
+                       ",\"blockIds\":[]}],\"seatCategoryId\":" + std::to_string(338937295 + p) + "}";
+            out += "],\"seatMapImage\":null,\"start\":" + std::to_string(1372701600000ULL + rng.next()) + ",\"venueCode\":\"PLEYEL_PLEYEL\"}";
+        }
+        out += "],\"venueNames\":{\"PLEYEL_PLEYEL\":\"Salle Pleyel\"}}";
+        return out;
+    }
+
+    /* 函数名称: make_deep
+     * 功能描述: 深层嵌套：对象与数组交替嵌套 depth 层，考验递归与栈使用。
+     */
+    inline auto make_deep(size_t depth, uint32_t seed) -> std::string
+    {
+        Lcg rng{seed};
+        std::string out;
+        for (size_t i = 0; i < depth; i++)
+            out += i % 2 ? "[" + std::to_string(rng.pick(100)) + "," : "{\"level\":" + std::to_string(i) + ",\"child\":";
+        out += "{\"leaf\":true}";
+        for (size_t i = depth; i-- > 0;)
+            out += i % 2 ? ']' : '}';
+        return out;
+    }
+
+    /* 函数名称: make_wide
+     * 功能描述: 宽对象：单个对象含大量成员，考验键查找与对象容器。
+     */
+    inline auto make_wide(size_t target_bytes, uint32_t seed) -> std::string
+    {
+        Lcg rng{seed};
+        std::string out = "{";
+        out.reserve(target_bytes + 64);
+        for (size_t i = 0; out.size() < target_bytes; i++)
+        {
+            out += i ? ",\"field_" : "\"field_";
+            out += std::to_string(i) + "\":";
+            switch (rng.pick(3))
+            {
+            case 0:
+                out += std::to_string(rng.next());
+                break;
+            case 1:
+                out += "\"value " + std::to_string(rng.pick(1000)) + "\"";
+                break;
+            default:
+                out += rng.pick(2) ? "true" : "null";
+            }
+        }
+        out += "}";
+        return out;
+    }
+
+    /* 函数名称: make_strings
+     * 功能描述: 以长字符串为主：中英文混排、各类转义（\"、\\、\n、\t、é、代理对）。
+     */
+    inline auto make_strings(size_t target_bytes, uint32_t seed) -> std::string
     {
-        out << JsonGenerator::generate(t);
+        static const char *pieces[] = {"The quick brown fox jumps over the lazy dog. ", "菜鸟教程提供了基础编程技术教程。", "\\\"quoted\\\" ",
+                                       "back\\\\slash ", "line\\nbreak ", "tab\\tstop ", "caf\\u00e9 ", "emoji \\ud83d\\ude00 ", "データ構造とアルゴリズム "};
+        Lcg rng{seed};
+        std::string out = "[";
+        out.reserve(target_bytes + 4096);
+        while (out.size() < target_bytes)
+        {
+            out += out.size() > 1 ? ",\"" : "\"";
+            size_t n = 4 + rng.pick(60);
+            for (size_t i = 0; i < n; i++)
+                out += pieces[rng.pick(9)];
+            out += '"';
+        }
+        out += "]";
         return out;
     }
 
+    /*
+     * 结构体: Corpus
+     * 描述: 一组同类文档。
+     */
+    struct Corpus
+    {
+        std::string name;
+        std::vector<std::string> docs;
+        size_t bytes = 0;
+    };
+
+    /* 函数名称: make_corpus
+     * 功能描述: 按名称生成总量约 total_bytes 的语料，第 i 篇文档的种子为 i + 1。
+     */
+    inline auto make_corpus(const std::string &name, size_t total_bytes) -> Corpus
+    {
+        Corpus c{name, {}, 0};
+        for (uint32_t seed = 1; c.bytes < total_bytes; seed++)
+        {
+            std::string doc;
+            if (name == "twitter")
+                doc = make_twitter(128 << 10, seed);
+            else if (name == "canada")
+                doc = make_canada(512 << 10, seed);
+            else if (name == "citm")
+                doc = make_citm(256 << 10, seed);
+            else if (name == "deep")
+                doc = make_deep(256, seed);
+            else if (name == "wide")
+                doc = make_wide(64 << 10, seed);
+            else if (name == "numeric")
+                doc = make_numbers(64 << 10, seed);
+            else if (name == "strings")
+                doc = make_strings(64 << 10, seed);
+            else if (name == "records")
+                doc = make_records(16 << 10, seed);
+            else
+                return c;
+            c.bytes += doc.size();
+            c.docs.push_back(std::move(doc));
+        }
+        return c;
+    }
+
+    /* 函数名称: access
+     * 功能描述: 只通过 Node::operator[] 遍历整棵树（对象按键、数组按下标），返回访问到的值个数。
+     */
+    inline auto access(Node &node) -> size_t
+    {
+        size_t visited = 1;
+        if (auto *obj = std::get_if<Object>(&node.value))
+        {
+            for (auto &member : *obj)
+                visited += access(node[member.first.str()]);
+        }
+        else if (auto *arr = std::get_if<Array>(&node.value))
+        {
+            for (size_t i = 0; i < arr->size(); i++)
+            {
+                auto &child = node[i];
+                visited += access(child);
+            }
+        }
+        return visited;
+    }
+
+    /* 函数名称: tree_rss_kb
+     * 功能描述: 在子进程中解析整份语料并持有全部 Node 树，返回峰值 RSS 相对 fork 时的增长（KB）。
+     *           应在父进程做任何解析之前调用，否则子进程会复用父进程已释放的堆而低估增长。
+     */
+    inline auto tree_rss_kb(const Corpus &c) -> long
+    {
+        long peak = 0;
+#ifdef JSON_HAS_MMAP
+        int fds[2];
+        if (::pipe(fds) != 0)
+            return 0;
+        std::fflush(stdout);
+        pid_t pid = ::fork();
+        if (pid == 0)
+        {
+            reset_peak_rss();
+            struct rusage ru;
+            ::getrusage(RUSAGE_SELF, &ru);
+            long base = ru.ru_maxrss;
+            std::vector<Node> held;
+            for (const auto &d : c.docs)
+                held.push_back(parser(d).value());
+            ::getrusage(RUSAGE_SELF, &ru);
+            long kb = ru.ru_maxrss - base;
+            ssize_t n = ::write(fds[1], &kb, sizeof(kb));
+            ::_exit(n == sizeof(kb) ? 0 : 1);
+        }
+        int status;
+        ::waitpid(pid, &status, 0);
+        if (::read(fds[0], &peak, sizeof(peak)) != sizeof(peak))
+            peak = 0;
+        ::close(fds[0]);
+        ::close(fds[1]);
+#endif
+        return peak;
+    }
+
+    /* 函数名称: run_suite
+     * 功能描述: 对每种语料测量 parser()、JsonGenerator::generate、operator[] 遍历与往返（解析 -> 生成 -> 再解析）
+     *           的 MB/s、docs/s、每文档分配次数与持有全部 Node 树时的峰值 RSS 增量。only 非空时只跑该语料。
+     *           有任一语料往返不一致时返回 1，便于在升级前做回归检查。
+     */
+    inline int run_suite(size_t bytes, const std::string &only)
+    {
+        static const char *names[] = {"twitter", "canada", "citm", "deep", "wide", "numeric", "strings", "records"};
+        std::printf("%-8s %5s %9s | %8s %9s %9s | %8s | %8s | %8s %3s | %10s\n", "corpus", "docs", "KB", "parse", "docs/s",
+                    "alloc/doc", "generate", "access", "roundtrip", "ok", "tree RSS");
+        std::printf("%-8s %5s %9s | %8s %9s %9s | %8s | %8s | %8s %3s | %10s\n", "", "", "", "MB/s", "", "", "MB/s", "MB/s",
+                    "MB/s", "", "KB");
+        std::vector<long> peaks; // 先测全部语料的 RSS，再做计时
+        for (const char *name : names)
+            if (only.empty() || only == name)
+                peaks.push_back(tree_rss_kb(make_corpus(name, bytes)));
+
+        bool all_ok = true;
+        size_t k = 0;
+        for (const char *name : names)
+        {
+            if (!only.empty() && only != name)
+                continue;
+            Corpus c = make_corpus(name, bytes);
+            double mb = c.bytes / 1e6;
+            simd::StructuralIndex index;
+
+            double t_parse = best_of(3, [&]
+                                     { for (const auto &d : c.docs) parser(d, index).value(); });
+            std::vector<Node> trees;
+            size_t before = allocations.load();
+            for (const auto &d : c.docs)
+                trees.push_back(std::move(*parser(d, index)));
+            double allocs = double(allocations.load() - before) / c.docs.size();
+
+            double t_generate = best_of(3, [&]
+                                        { for (const auto &t : trees) JsonGenerator::generate(t); });
+            size_t visited = 0;
+            double t_access = best_of(3, [&]
+                                      { visited = 0; for (auto &t : trees) visited += access(t); });
+
+            bool ok = true;
+            double t_round = best_of(3, [&]
+                                     {
+                ok = true;
+                for (const auto &d : c.docs)
+                {
+                    std::string once = JsonGenerator::generate(parser(d, index).value());
+                    ok = ok && JsonGenerator::generate(parser(once, index).value()) == once;
+                } });
+            all_ok = all_ok && ok;
+            std::printf("%-8s %5zu %9zu | %8.1f %9.0f %9.1f | %8.1f | %8.1f | %8.1f %3s | %10ld\n", name, c.docs.size(),
+                        c.bytes >> 10, mb / t_parse, c.docs.size() / t_parse, allocs, mb / t_generate,
+                        mb / t_access, mb / t_round, ok ? "yes" : "no", peaks[k++]);
+        }
+        return all_ok ? 0 : 1;
+    }
+
+    /* 函数名称: run_reuse
+     * 功能描述: 逐行解析 NDJSON（大量形状相同的小文档），比较每次新建树的 json::parser 与复用 Parser + Document
+     *           的 docs/s 和稳定后的每文档分配次数，并核对两者的解析结果一致。
+     */
+    inline int run_reuse(size_t bytes)
+    {
+        std::string buf = make_ndjson(bytes);
+        std::vector<std::string_view> lines;
+        ndjson::for_each_line(buf, [&](std::string_view line, size_t)
+                              { lines.push_back(line); });
+        std::printf("input: %zu bytes, %zu documents\n", buf.size(), lines.size());
+
+        simd::StructuralIndex index;
+        auto fresh = [&]
+        { for (auto line : lines) parser(line, index).value(); };
+        Parser p;
+        Document doc;
+        bool ok = true;
+        auto reused = [&]
+        { for (auto line : lines) ok = p.parse(line, doc) && ok; };
+
+        for (auto [name, run] : {std::pair<const char *, std::function<void()>>{"parser() per doc", fresh},
+                                 {"Parser + Document", reused}})
+        {
+            double t = best_of(3, run); // 同时让回收池达到稳定
+            size_t before = allocations.load();
+            run();
+            std::printf("%-20s %12.0f docs/s %8.1f MB/s %8.2f allocations/doc\n", name, lines.size() / t,
+                        buf.size() / t / 1e6, double(allocations.load() - before) / lines.size());
+        }
+
+        for (auto line : lines)
+        {
+            ok = p.parse(line, doc) && ok;
+            ok = ok && generate(doc.root()) == generate(parser(line).value());
+        }
+        std::printf("results: %s\n", ok ? "identical" : "MISMATCH");
+        return ok ? 0 : 1;
+    }
+
+    /* 函数名称: run_snapshot
+     * 功能描述: 一个写者不断更新共享配置、多个读者同时读取。先比较单次编辑的代价（深复制 json::Node 再修改，
+     *           与 persistent 的路径复制 x["version"] = ...），再比较读写锁保护的 json::Node 与
+     *           persistent::Store 在没有写者和有写者时的读者吞吐量。写者每次同时更新 version 和 checksum，
+     *           读者检查二者一致，以确认每个快照都是某次更新后的完整状态。
+     */
+    inline int run_snapshot(size_t bytes)
+    {
+        json::Object object;
+        object.insert_or_assign("version", Node{Int(0)});
+        object.insert_or_assign("checksum", Node{Int(0)});
+        object.insert_or_assign("records", parser(make_records(bytes)).value());
+        Node config{std::move(object)};
+        std::printf("config: %zu bytes\n", generate(config).size());
+
+        // 单次编辑的代价
+        const int edits = 20;
+        double t_copy = best_of(3, [&]
+                                {
+            for (int i = 0; i < edits; i++)
+            {
+                Node copy = config;
+                copy["version"] = Node{Int(i)};
+            } });
+        size_t before = allocations.load();
+        {
+            Node copy = config;
+            copy["version"] = Node{Int(114514)};
+        }
+        size_t copy_allocs = allocations.load() - before;
+
+        persistent::Node root{config};
+        const int path_edits = 100000;
+        double t_path = best_of(3, [&]
+                                {
+            persistent::Editor x{root};
+            for (int i = 0; i < path_edits; i++)
+                x["version"] = i; });
+        before = allocations.load();
+        persistent::Editor x{root};
+        x["version"] = 114514;
+        size_t path_allocs = allocations.load() - before;
+        bool shared = x.root()["records"].shares(root["records"]) && root["version"].as_int() == 0;
+        std::printf("%-28s %12.0f edits/s %10zu allocations/edit\n", "deep copy + edit", edits / t_copy, copy_allocs);
+        std::printf("%-28s %12.0f edits/s %10zu allocations/edit (records shared: %s)\n", "path copy x[\"version\"] = ..",
+                    path_edits / t_path, path_allocs, shared ? "yes" : "no");
+
+        // 读者吞吐量
+        const unsigned readers = std::max(2u, std::thread::hardware_concurrency());
+        std::atomic<size_t> inconsistent{0};
+        auto measure = [&](const char *name, const std::function<bool()> &read, const std::function<void()> &write)
+        {
+            for (bool writing : {false, true})
+            {
+                std::atomic<bool> stop{false};
+                std::atomic<size_t> reads{0};
+                size_t updates = 0;
+                std::vector<std::thread> threads;
+                for (unsigned r = 0; r < readers; r++)
+                    threads.emplace_back([&]
+                                         {
+                        size_t n = 0;
+                        while (!stop.load(std::memory_order_relaxed))
+                        {
+                            if (!read())
+                                inconsistent.fetch_add(1);
+                            n++;
+                        }
+                        reads.fetch_add(n); });
+                if (writing)
+                    threads.emplace_back([&]
+                                         {
+                        while (!stop.load(std::memory_order_relaxed))
+                        {
+                            write();
+                            updates++;
+                            std::this_thread::yield();
+                        } });
+                auto start = std::chrono::steady_clock::now();
+                std::this_thread::sleep_for(std::chrono::milliseconds(300));
+                stop = true;
+                for (auto &t : threads)
+                    t.join();
+                double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                std::printf("%-28s %12.0f reads/s %10.0f updates/s  (%u readers%s)\n", name, reads / t, updates / t, readers,
+                            writing ? " + 1 writer" : "");
+            }
+        };
+
+        std::shared_mutex lock;
+        Int next = 0;
+        measure(
+            "shared_mutex + json::Node", [&]
+            {
+                std::shared_lock guard(lock);
+                const Node &c = config;
+                return std::get<Int>(c["checksum"].value) == 2 * std::get<Int>(c["version"].value); },
+            [&]
+            {
+                std::unique_lock guard(lock);
+                ++next;
+                config["version"] = Node{next};
+                config["checksum"] = Node{2 * next};
+            });
+
+        persistent::Store store{root};
+        measure(
+            "persistent::Store::load", [&]
+            {
+                auto snap = store.load();
+                return snap["checksum"].as_int() == 2 * snap["version"].as_int(); },
+            [&]
+            {
+                ++next;
+                store.update([&](persistent::Editor &x)
+                             {
+                    x["version"] = next;
+                    x["checksum"] = 2 * next; });
+            });
+        measure(
+            "persistent::Store::read", [&]
+            { return store.read([](const persistent::Node &snap)
+                                { return snap["checksum"].as_int() == 2 * snap["version"].as_int(); }); },
+            [&]
+            {
+                ++next;
+                store.update([&](persistent::Editor &x)
+                             {
+                    x["version"] = next;
+                    x["checksum"] = 2 * next; });
+            });
+
+        std::printf("inconsistent snapshots: %zu\n", inconsistent.load());
+        return shared && inconsistent == 0 ? 0 : 1;
+    }
+
+    /* 函数名称: run_syntax
+     * 功能描述: 用一组合法和非法的输入检查各解析模式的接受 / 拒绝是否与 parser() 一致，任何一项不符时返回 1。
+     *           非法输入主要是结构索引跳过空白时容易漏掉的情况：字面量和数字之后紧跟的多余字符。
+     */
+    inline int run_syntax()
+    {
+        struct Case
+        {
+            std::string_view json;
+            bool valid;
+        };
+        static const Case cases[] = {
+            {"[true, false, null]", true},
+            {"{\"a\":false,\"b\":null,\"c\":true}", true},
+            {"[1,-2.5e3 ,0]", true},
+            {"[truex]", false},
+            {"{\"a\":falsey}", false},
+            {"[nullz]", false},
+            {"truex", false},
+            {"[true1]", false},
+            {"[12x]", false},
+            {"[\"a\\u0041\", \"\\\"b\\n\"]", true},
+            {"{\"k\\u0065y\":1}", true},
+            {"[\"a\x01\"]", false},
+            {"[\"\\q\"]", false},
+            {"[\"\xff\"]", false},
+            {"[\"\xc3\"]", false},
+            {" [1] \n", true},
+            {"1 2", false},
+            {"{} x", false},
+            {"[1] ]", false},
+            {"[1e400]", false},
+            {"[-1e400]", false},
+            {"[1e-400, 1e308]", true},
+            {"[1,\t2\r\n]", true},
+            {"[1,\v2]", false},
+            {"\f[1]", false},
+        };
+
+        bool ok = true;
+        auto check = [&](const char *mode, std::string_view json, bool expected, bool accepted)
+        {
+            if (accepted != expected)
+            {
+                ok = false;
+                std::printf("FAILED %-10s %s: %s\n", mode, expected ? "rejected" : "accepted", std::string(json).c_str());
+            }
+        };
+        for (const auto &c : cases)
+        {
+            check("parser", c.json, c.valid, parser(c.json).has_value());
+            tape::Document tape_doc;
+            check("tape", c.json, c.valid, tape::parse(c.json, tape_doc).has_value());
+            tape::Arena side;
+            check("borrowed", c.json, c.valid, borrowed::parse(c.json, side).has_value());
+            check("compact", c.json, c.valid, compact::parse(c.json).has_value());
+            sax::Handler handler;
+            check("sax", c.json, c.valid, sax::parse(c.json, handler) == sax::Status::Done);
+        }
+
+        // ndjson：一行中的第二条记录或行尾的损坏内容使整行失败，而不是被静默丢弃
+        {
+            ThreadPool pool(1);
+            auto lines = ndjson::parse("{\"a\":1} {\"b\":2}\n{\"a\":1} garbage\n[1] \r\n", pool);
+            bool as_expected = lines.size() == 3 && !lines[0] && !lines[1] && lines[2];
+            check("ndjson", "{\"a\":1} {\"b\":2} / {\"a\":1} garbage", true, as_expected);
+        }
+
+        // 解码后的字符串：经 tape 转换回 Node 再生成，必须与 parser() 的结果相同；转义的键也能按解码后的文本查找
+        for (std::string_view json : {"[\"a\\u0041\",\"a\\\"b\\n\",\"\\ud83c\\udf63\"]", "{\"k\\u0065y\":\"v\\/\"}"})
+        {
+            tape::Document tape_doc;
+            auto root = tape::parse(json, tape_doc);
+            bool same = root && generate(root->to_node()) == generate(parser(json).value());
+            check("tape text", json, true, same);
+        }
+        // 各模式的对象成员顺序都与 parser() 相同（文档顺序，重复的键保留第一次出现的位置、最后一次的值）
+        for (std::string_view json : {"{\"b\":1,\"a\":{\"z\":2,\"y\":3},\"c\":4}", "{\"x\":1,\"w\":2,\"x\":3}"})
+        {
+            tape::Arena side;
+            auto root = borrowed::parse(json, side);
+            check("borrowed order", json, true, root && generate(root->to_node()) == generate(parser(json).value()));
+        }
+        {
+            tape::Document tape_doc;
+            auto root = tape::parse("{\"k\\u0065y\":7}", tape_doc);
+            check("tape key", "{\"k\\u0065y\":7}", true, root && (*root)["key"].as_int() == 7);
+        }
+
+        // ondemand：跳过的子树不检查，但实际读取的值必须与 DOM 同样严格
+        struct Read
+        {
+            std::string_view json;
+            bool valid;
+            int kind; // 0 字符串，1 布尔，2 整数，3 浮点数
+        };
+        static const Read ondemand_cases[] = {
+            {"{\"a\":\"x\\u0041\\n\"}", true, 0},
+            {"{\"a\":\"x\x01y\"}", false, 0},
+            {"{\"a\":\"\xff\"}", false, 0},
+            {"{\"a\":\"\\q\"}", false, 0},
+            {"{\"a\":true}", true, 1},
+            {"{\"a\":truex}", false, 1},
+            {"{\"a\":12}", true, 2},
+            {"{\"a\":12x}", false, 2},
+            {"{\"a\":1.5e3}", true, 3},
+            {"{\"a\":1.5x}", false, 3},
+        };
+        {
+            // 转义的键只按解码后的文本匹配，不能与源文本中的转义序列相等
+            ondemand::Document doc;
+            auto root = ondemand::parse("{\"x\\n\":1,\"y\":2}", doc).value();
+            bool decoded = root["x\n"].get_int() == 1, raw_matched = true;
+            try
+            {
+                root["x\\n"];
+            }
+            catch (const std::runtime_error &)
+            {
+                raw_matched = false;
+            }
+            check("ondemand key", "{\"x\\n\":1}", true, decoded && !raw_matched);
+        }
+        {
+            // Path 在原始文本上求值时使用同样的键比较
+            ondemand::Document doc;
+            auto decoded = Path::compile("/x\n").value().evaluate("{\"x\\n\":1}", doc);
+            auto raw = Path::compile("/x\\n").value().evaluate("{\"x\\n\":1}", doc);
+            check("path key", "{\"x\\n\":1}", true, decoded && decoded->size() == 1 && raw && raw->empty());
+        }
+        for (const auto &c : ondemand_cases)
+        {
+            ondemand::Document doc;
+            bool read = false;
+            try
+            {
+                auto a = ondemand::parse(c.json, doc).value()["a"];
+                c.kind == 0 ? (void)a.get_string() : c.kind == 1 ? (void)a.get_bool() : c.kind == 2 ? (void)a.get_int() : (void)a.get_double();
+                read = true;
+            }
+            catch (const std::runtime_error &)
+            {
+            }
+            check("ondemand", c.json, c.valid, read);
+        }
+
+        // push::Parser 整块送入和逐字节送入（块边界落在任意位置）的结果都必须符合预期
+        static const Case push_cases[] = {
+            {"[\"a\x01\"]", false},
+            {"[\"\xff\"]", false},
+            {"[\"\xc3\xa9\", \"\\u00e9\"]", true},
+            {"1[2]", false},
+            {"[1e400]", false},
+            {"\"a\"\"b\"", false},
+            {"[1][2]", false},
+            {"true\"x\"", false},
+            {"1 2", true},
+            {"{\"a\":1}\n{\"b\":[true,null]}\n", true},
+            {"[truex]", false},
+            {"[nul]", false},
+            {"[fals e]", false},
+        };
+        for (const auto &c : push_cases)
+        {
+            sax::Handler handler;
+            push::Parser<sax::Handler> whole(handler), bytes(handler);
+            whole.feed(c.json);
+            check("push", c.json, c.valid, whole.finish() == push::Status::Done);
+            for (char ch : c.json)
+                bytes.feed(std::string_view{&ch, 1});
+            check("push bytes", c.json, c.valid, bytes.finish() == push::Status::Done);
+        }
+        {
+            // 不可能成为字面量的记号必须在送入时立即失败，而不是缓存到 finish()
+            sax::Handler handler;
+            push::Parser<sax::Handler> stream(handler);
+            bool failed = false;
+            for (int k = 0; k < 6 && !failed; k++)
+                failed = stream.feed("t") == push::Status::Error;
+            check("push literal", "tttttt...", false, !failed);
+        }
+
+        // bind::parse 直接写结构体，单独检查：尾随逗号、数字后的多余字符、根之后的多余内容
+        static const Case bind_cases[] = {
+            {"{\"age\":1,\"phoneNumbers\":[\"a\",\"b\"]}", true},
+            {" {\"age\":1,\"phoneNumbers\":[]} \n", true},
+            {"{}", true},
+            {"{\"age\":1,\"phoneNumbers\":[\"a\",]}", false},
+            {"{\"age\":1,}", false},
+            {"{,}", false},
+            {"{\"age\":12x}", false},
+            {"{\"score\":1.5x}", false},
+            {"{\"score\":1e400}", false},
+            {"{\"active\":truex}", false},
+            {"{\"age\":1} junk", false},
+            {"{\"name\":\"\xff\"}", false},
+            {"{\"name\":\"a\x01\"}", false},
+            {"{\"zz\":[1,{\"q\":[true,null,\"x\\n\"]},{}],\"age\":2}", true},
+            {"{\"zz\":[1}, \"a\":1}", false},
+            {"{\"zz\":[tru, @@], \"a\":2}", false},
+            {"{\"zz\":{\"q\" 1 2}, \"a\":3}", false},
+            {"{\"zz\":[1,], \"age\":4}", false},
+        };
+        for (const auto &c : bind_cases)
+            check("bind", c.json, c.valid, bind::parse<Person>(c.json).has_value());
+
+        std::printf("%zu cases: %s\n", std::size(cases) + std::size(ondemand_cases) + std::size(push_cases) + std::size(bind_cases), ok ? "ok" : "FAILED");
+        return ok ? 0 : 1;
+    }
+
+    /* 函数名称: run_allocs
+     * 功能描述: 统计每次解析的堆分配次数：深层文档的分配数应随深度线性增长（深度翻倍时至多约翻倍），
+     *           用来防止解析路径上重新出现按值复制子树；同时报告 records 语料的每文档分配数。
+     *           检查失败时返回 1。
+     */
+    inline int run_allocs()
+    {
+        simd::StructuralIndex index;
+        auto count = [&](const std::string &doc)
+        {
+            parser(doc, index).value(); // 预热索引缓冲区，不计入统计
+            size_t before = allocations.load();
+            parser(doc, index).value();
+            return allocations.load() - before;
+        };
+
+        bool ok = true;
+        size_t previous = 0;
+        for (size_t depth : {64, 128, 256, 512})
+        {
+            size_t n = count(make_deep(depth, 1));
+            double ratio = previous ? double(n) / previous : 0;
+            bool linear = !previous || ratio <= 2.1;
+            ok = ok && linear;
+            std::printf("deep %4zu: %7zu allocations/parse", depth, n);
+            if (previous)
+                std::printf("  x%.2f%s", ratio, linear ? "" : " (superlinear)");
+            std::printf("\n");
+            previous = n;
+        }
+
+        Corpus records = make_corpus("records", 1u << 20);
+        size_t total = 0;
+        for (const auto &d : records.docs)
+            total += count(d);
+        std::printf("records: %.1f allocations/doc (%zu docs)\n", double(total) / records.docs.size(), records.docs.size());
+
+        // 复用 Parser + Document 反复解析同一组文档，稳定后不应再分配
+        Parser p;
+        Document doc;
+        for (int round = 0; round < 2; round++)
+            for (const auto &d : records.docs)
+                p.parse(d, doc);
+        size_t before = allocations.load();
+        for (const auto &d : records.docs)
+            p.parse(d, doc);
+        size_t reused = allocations.load() - before;
+        std::printf("records reused: %zu allocations\n", reused);
+
+        ok = ok && reused == 0;
+        std::printf("%s\n", ok ? "ok" : "FAILED: allocations grow faster than document depth or reuse allocates");
+        return ok ? 0 : 1;
+    }
+
+    /* 函数名称: run_stats
+     * 功能描述: 解析并生成一份记录文档后打印当前线程的 json::stats 计数（需要用 -DJSON_STATS=1 编译）。
+     */
+    inline int run_stats(size_t bytes)
+    {
+        if (!stats::enabled)
+        {
+            std::printf("json::stats is compiled out; rebuild with -DJSON_STATS=1\n");
+            return 0;
+        }
+        std::string doc = make_records(bytes);
+        stats::reset();
+        auto node = parser(doc).value();
+        std::string out = generate(node);
+        const auto &c = stats::counters();
+        const auto &p = c.parse;
+        auto ms = [](uint64_t ns)
+        { return double(ns) / 1e6; };
+        std::printf("parse: %zu docs, %zu bytes, %zu tokens, max depth %zu\n", p.documents, p.bytes, p.tokens(), p.max_depth);
+        std::printf("  tokens: null %zu, bool %zu, int %zu, float %zu, string %zu, key %zu, array %zu, object %zu\n",
+                    p.nulls, p.bools, p.ints, p.floats, p.strings, p.keys, p.arrays, p.objects);
+        std::printf("  allocations: %zu (%zu bytes)\n", p.allocations, p.allocated_bytes);
+        std::printf("  time: total %.1f ms = stage1 %.1f + whitespace %.1f + string %.1f + number %.1f + container %.1f\n",
+                    ms(p.total_ns), ms(p.stage1_ns), ms(p.whitespace_ns), ms(p.string_ns), ms(p.number_ns), ms(p.container_ns()));
+        std::printf("generate: %zu docs, %zu bytes, %zu allocations (%zu bytes), %.1f ms\n", c.generate.documents,
+                    c.generate.bytes, c.generate.allocations, c.generate.allocated_bytes, ms(c.generate.total_ns));
+        return p.bytes == doc.size() && c.generate.bytes == out.size() ? 0 : 1;
+    }
+}
+
+/* 替换全局 operator new/delete，以便基准测试统计堆分配次数，并把分配计入 json::stats（启用时） */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void *operator new(size_t size)
+{
+    bench::allocations.fetch_add(1, std::memory_order_relaxed);
+    json::stats::record_allocation(size);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
 }
-using namespace json; // 使用 json 命名空间
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+#pragma GCC diagnostic pop
 
-int main()
+int main(int argc, char *argv[])
 {
-    // 打开文件并读取 JSON 数据
-    std::ifstream fin("json.txt");
-    std::stringstream ss;
-    ss << fin.rdbuf();
-    std::string s{ss.str()}; // 将文件内容转换为字符串
-
-    // 解析 JSON 字符串并获取节点
-    auto x = parser(s).value(); // 解析 JSON 字符串，并获取解析结果的有效节点
+    if (argc > 1)
+    {
+        std::string cmd = argv[1];
+        if (cmd == "ndjson" && argc > 2)
+            return bench::run_ndjson_file(argv[2]);
+        if (cmd == "push")
+            return bench::run_push_stdin();
+        size_t bytes = argc > 2 ? std::stoul(argv[2]) : (16u << 20); // 默认 16MB 输入
+        if (cmd == "bench-index")
+            return bench::run_index(bytes);
+        if (cmd == "bench-strings")
+            return bench::run_strings(bytes);
+        if (cmd == "bench-tape")
+            return bench::run_tape(bytes);
+        if (cmd == "bench-borrowed")
+            return bench::run_borrowed(bytes);
+        if (cmd == "bench-sax")
+            return bench::run_sax(bytes);
+        if (cmd == "bench-ndjson")
+            return bench::run_ndjson(bytes);
+        if (cmd == "bench-mmap")
+            return bench::run_mmap(bytes);
+        if (cmd == "bench-binary")
+            return bench::run_binary(bytes);
+        if (cmd == "bench-numbers")
+            return bench::run_numbers(bytes);
+        if (cmd == "bench-generate")
+            return bench::run_generate(bytes);
+        if (cmd == "bench-push")
+            return bench::run_push(bytes);
+        if (cmd == "bench-ondemand")
+            return bench::run_ondemand(bytes);
+        if (cmd == "bench-path")
+            return bench::run_path(bytes);
+        if (cmd == "bench-intern")
+            return bench::run_intern(bytes);
+        if (cmd == "bench-compact")
+            return bench::run_compact(bytes);
+        if (cmd == "bench-bind")
+            return bench::run_bind(bytes);
+        if (cmd == "bench-reuse")
+            return bench::run_reuse(bytes);
+        if (cmd == "bench-snapshot")
+            return bench::run_snapshot(argc > 2 ? bytes : (1u << 20)); // 默认 1MB 配置
+        if (cmd == "stats")
+            return bench::run_stats(bytes);
+        if (cmd == "check-syntax")
+            return bench::run_syntax();
+        if (cmd == "check-allocs")
+            return bench::run_allocs();
+        if (cmd == "bench-suite")
+            return bench::run_suite(argc > 2 ? bytes : (2u << 20), argc > 3 ? argv[3] : ""); // 默认每种语料 2MB
+        std::cerr << "unknown command: " << cmd << "\n";
+        return 1;
+    }
+
+    // 映射 json.txt 并直接在映射上解析，获取解析结果的有效节点
+    auto x = parse_file("json.txt").value();
 
     // 打印解析结果
     std::cout << x << "\n"; // 打印解析后的 JSON 数据